@@ -1,6 +1,7 @@
 #include "Activity.h"
 #include <algorithm>
-#include <sstream>
+#include <charconv>
+#include <stdexcept>
 #include <ctime>
 #include <utility>
 
@@ -8,7 +9,7 @@
 Activity::Activity(std::string  desc, bool comp, time_t date) : description(std::move(desc)), completed(comp), dueDate(date) {}
 
 // Getters: Retrieve the values of private attributes
-std::string Activity::getDescription() const {
+const std::string& Activity::getDescription() const {
     return description;
 }
 
@@ -33,28 +34,97 @@ time_t Activity::getDueDate() const {
     return dueDate;
 }
 
-// Serializes the activity into a string format: "description;1;1678902345"
+ActivityId Activity::getId() const {
+    return id;
+}
+
+void Activity::setId(ActivityId newId) {
+    id = newId;
+}
+
+// Formats the activity the way TodoList::toString lists it
+std::string Activity::toString() const {
+    std::string dueDateStr = std::ctime(&dueDate);
+    dueDateStr.erase(dueDateStr.find_last_not_of('\n') + 1);
+    return description + " [" + (completed ? "Done" : "Not Done") + "] (Due: " + dueDateStr + ")";
+}
+
+// Serializes the activity into a string format: "description;1;1678902345", followed by ";id" once an id is assigned
 std::string Activity::serialize() const {
-    return description + ";" + (completed ? "1" : "0") + ";" + std::to_string(dueDate);
+    std::string buffer;
+    appendSerialized(buffer);
+    return buffer;
 }
 
-// Deserializes a string back into an Activity object
-Activity Activity::deserialize(const std::string& data) {
-    std::istringstream iss(data);
-    std::string desc, comp, dateStr;
+// Writes the same format straight into the caller's buffer
+void Activity::appendSerialized(std::string& buffer) const {
+    char date[24];
+    const auto result = std::to_chars(date, date + sizeof(date), static_cast<long long>(dueDate));
 
-    if (!(std::getline(iss, desc, ';') &&
-          std::getline(iss, comp, ';') &&
-          std::getline(iss, dateStr))) {
-        throw std::invalid_argument("Error: Malformed serialized string");
-          }
+    buffer += description;
+    buffer += completed ? ";1;" : ";0;";
+    buffer.append(date, result.ptr);
+    if (id != 0) {
+        char idText[24];
+        const auto idResult = std::to_chars(idText, idText + sizeof(idText), id);
+        buffer += ';';
+        buffer.append(idText, idResult.ptr);
+    }
+}
 
-    bool completed = (comp == "1");
+// Deserializes a string back into an Activity object.
+// Single pass without temporaries: the fields are located with find(), the date is parsed with
+// std::from_chars and only the description is copied, straight into the new Activity.
+Activity Activity::deserialize(std::string_view data) {
+    const size_t descEnd = data.find(';');
+    if (descEnd == std::string_view::npos) {
+        throw std::invalid_argument("Error: Malformed serialized string (no ';' after the description)");
+    }
+    const size_t compEnd = data.find(';', descEnd + 1);
+    if (compEnd == std::string_view::npos) {
+        throw std::invalid_argument("Error: Malformed serialized string (no ';' after the completion flag at position " +
+                                    std::to_string(descEnd + 1) + ")");
+    }
+
+    const bool completed = data.substr(descEnd + 1, compEnd - descEnd - 1) == "1";
+
+    const size_t dateBegin = compEnd + 1;
+    const size_t dateEnd = std::min(data.find(';', dateBegin), data.size()); // The id field is optional
+    if (dateBegin == dateEnd) {
+        throw std::invalid_argument("Error: Invalid due date in serialized string (empty at position " +
+                                    std::to_string(dateBegin) + ")");
+    }
+    const char* first = data.data() + dateBegin;
+    const char* last = data.data() + dateEnd;
+    for (const char* c = first; c != last; ++c) {
+        if (*c < '0' || *c > '9') {
+            throw std::invalid_argument("Error: Invalid due date in serialized string (unexpected character at position " +
+                                        std::to_string(c - data.data()) + ")");
+        }
+    }
+
+    long long dueDate = 0;
+    if (std::from_chars(first, last, dueDate).ec != std::errc()) {
+        throw std::out_of_range("Error: Due date out of range in serialized string (at position " +
+                                std::to_string(dateBegin) + ")");
+    }
 
-    if (dateStr.empty() || !std::all_of(dateStr.begin(), dateStr.end(), ::isdigit)) {
-        throw std::invalid_argument("Error: Invalid due date in serialized string");
+    ActivityId id = 0;
+    if (dateEnd != data.size()) {
+        const char* idFirst = data.data() + dateEnd + 1;
+        const char* idLast = data.data() + data.size();
+        const auto result = std::from_chars(idFirst, idLast, id);
+        if (idFirst == idLast || result.ptr != idLast) {
+            throw std::invalid_argument("Error: Invalid id in serialized string (at position " +
+                                        std::to_string(dateEnd + 1) + ")");
+        }
+        if (result.ec != std::errc()) {
+            throw std::out_of_range("Error: Id out of range in serialized string (at position " +
+                                    std::to_string(dateEnd + 1) + ")");
+        }
     }
 
-    std::time_t dueDate = std::stoll(dateStr);
-    return Activity(desc, completed, dueDate);
-}
\ No newline at end of file
+    Activity activity(std::string(data.substr(0, descEnd)), completed, static_cast<std::time_t>(dueDate));
+    activity.id = id;
+    return activity;
+}
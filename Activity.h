@@ -2,20 +2,26 @@
 #define ACTIVITY_H
 
 #include <string>
+#include <string_view>
 #include <ctime>
+#include <cstdint>
+
+// Stable identifier of an activity within its TodoList; 0 means "not assigned yet"
+using ActivityId = uint64_t;
 
 class Activity {
 private:
     std::string description;
     bool completed;
     time_t dueDate;
+    ActivityId id = 0; // Assigned by TodoList when the activity is added
 
 public:
     // Constructor with default parameters
     explicit Activity(std::string  desc, bool comp = false, time_t date = 0);
 
     // Getters for retrieving activity details
-    [[nodiscard]] std::string getDescription() const;
+    [[nodiscard]] const std::string& getDescription() const;
     [[nodiscard]] bool isCompleted() const;
 
     // Setters for modifying activity details
@@ -23,10 +29,19 @@ public:
     void setCompleted(bool comp);
     void setDueDate(time_t date);
     [[nodiscard]] time_t getDueDate() const;
+    [[nodiscard]] ActivityId getId() const;
+    void setId(ActivityId newId);
+
+    // Formats the activity for display: "description [Done] (Due: Thu Apr 10 15:00:00 2025)"
+    [[nodiscard]] std::string toString() const;
 
     // Methods for saving and loading activities as strings
     [[nodiscard]] std::string serialize() const;
-    static Activity deserialize(const std::string& data);
+    // Appends the serialized form to an existing buffer, avoiding a temporary string per activity
+    void appendSerialized(std::string& buffer) const;
+    // Parses "description;1;1678902345" or "description;1;1678902345;42" (with the id) in place;
+    // throws std::invalid_argument naming the offending position
+    static Activity deserialize(std::string_view data);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,59 @@
+#include "ActivityColumns.h"
+#include "ColumnKernels.h"
+
+void ActivityColumns::clear() {
+    dueDates.clear();
+    completedBits.clear();
+    count = 0;
+    retired = 0;
+}
+
+void ActivityColumns::reserve(size_t n) {
+    dueDates.reserve(n);
+    completedBits.reserve((n + 63) / 64);
+}
+
+void ActivityColumns::assign(const std::vector<Activity>& activities) {
+    clear();
+    reserve(activities.size());
+    for (const Activity& activity : activities) {
+        pushBack(activity);
+    }
+}
+
+void ActivityColumns::pushBack(const Activity& activity) {
+    if (count % 64 == 0) {
+        completedBits.push_back(0);
+    }
+    dueDates.push_back(static_cast<int64_t>(activity.getDueDate()));
+    ++count;
+    setCompleted(count - 1, activity.isCompleted());
+}
+
+// A retired slot counts as completed, so the pending and overdue kernels skip it unchanged
+void ActivityColumns::retire(size_t index) {
+    setCompleted(index, true);
+    ++retired;
+}
+
+void ActivityColumns::setCompleted(size_t index, bool completed) {
+    const uint64_t bit = uint64_t{1} << (index % 64);
+    if (completed) {
+        completedBits[index / 64] |= bit;
+    } else {
+        completedBits[index / 64] &= ~bit;
+    }
+}
+
+void ActivityColumns::setDueDate(size_t index, std::time_t dueDate) {
+    dueDates[index] = static_cast<int64_t>(dueDate);
+}
+
+// The scans below dispatch to the SIMD kernels selected for this CPU
+size_t ActivityColumns::countCompleted() const {
+    return countSetBits(completedBits.data(), completedBits.size()) - retired;
+}
+
+size_t ActivityColumns::countOverdue(std::time_t now) const {
+    return ::countOverdue(dueDates.data(), completedBits.data(), count, static_cast<int64_t>(now));
+}
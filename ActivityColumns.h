@@ -0,0 +1,48 @@
+#ifndef ACTIVITYCOLUMNS_H
+#define ACTIVITYCOLUMNS_H
+
+#include "Activity.h"
+#include <cstdint>
+#include <ctime>
+#include <vector>
+
+// Structure-of-arrays copy of the scalar fields of a TodoList's activities:
+// a contiguous due date column and a completion bitset, kept in slot order.
+// Scans over these touch 8 bytes + 1 bit per activity instead of a whole Activity.
+// Removed activities are retired in place and left out of every count.
+class ActivityColumns {
+private:
+    std::vector<int64_t> dueDates;
+    std::vector<uint64_t> completedBits; // Bit i is set when activity i is completed (or retired)
+    size_t count = 0;
+    size_t retired = 0;
+
+public:
+    void clear();
+    void reserve(size_t n);
+    void assign(const std::vector<Activity>& activities);
+
+    void pushBack(const Activity& activity);
+    // Retires a slot without shifting the following entries
+    void retire(size_t index);
+    void setCompleted(size_t index, bool completed);
+    void setDueDate(size_t index, std::time_t dueDate);
+
+    // Number of slots, retired ones included
+    [[nodiscard]] size_t size() const { return count; }
+    [[nodiscard]] size_t retiredCount() const { return retired; }
+    [[nodiscard]] bool isCompleted(size_t index) const { return (completedBits[index / 64] >> (index % 64)) & 1U; }
+    [[nodiscard]] std::time_t getDueDate(size_t index) const { return static_cast<std::time_t>(dueDates[index]); }
+
+    // Raw columns for bulk kernels
+    [[nodiscard]] const int64_t* dueDateData() const { return dueDates.data(); }
+    [[nodiscard]] const uint64_t* completedData() const { return completedBits.data(); }
+    [[nodiscard]] size_t completedWords() const { return completedBits.size(); }
+
+    // Number of completed activities (popcount over the bitset)
+    [[nodiscard]] size_t countCompleted() const;
+    // Number of pending activities due strictly before now
+    [[nodiscard]] size_t countOverdue(std::time_t now) const;
+};
+
+#endif
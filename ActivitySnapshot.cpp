@@ -0,0 +1,64 @@
+#include "ActivitySnapshot.h"
+#include <algorithm>
+#include <sstream>
+#include <utility>
+
+std::shared_ptr<const ActivityChunk> ActivityChunk::copyFrom(const std::vector<Activity>& storage, const LiveSlots& liveSlots,
+                                                             size_t index) {
+    const size_t first = index * SIZE;
+    const size_t last = std::min(first + SIZE, storage.size());
+    auto chunk = std::make_shared<ActivityChunk>();
+    chunk->activities.assign(storage.begin() + static_cast<std::ptrdiff_t>(first),
+                             storage.begin() + static_cast<std::ptrdiff_t>(last));
+    chunk->live.resize(last - first);
+    for (size_t slot = first; slot < last; ++slot) {
+        chunk->live[slot - first] = liveSlots.isLive(slot);
+    }
+    return chunk;
+}
+
+ActivitySnapshot::ActivitySnapshot(std::string listName, std::vector<std::shared_ptr<const ActivityChunk>> slotChunks,
+                                   std::shared_ptr<const DueDateIndex> order, size_t live, uint64_t listVersion)
+    : name(std::move(listName)), chunks(std::move(slotChunks)), dueDateOrder(std::move(order)), liveCount(live),
+      version(listVersion) {
+    for (const auto& chunk : chunks) {
+        slotCount += chunk->activities.size();
+    }
+}
+
+const Activity& ActivitySnapshot::slot(size_t index) const {
+    return chunks[index / ActivityChunk::SIZE]->activities[index % ActivityChunk::SIZE];
+}
+
+bool ActivitySnapshot::isLive(size_t index) const {
+    return chunks[index / ActivityChunk::SIZE]->live[index % ActivityChunk::SIZE];
+}
+
+std::vector<Activity> ActivitySnapshot::getActivities() const {
+    std::vector<Activity> result;
+    result.reserve(liveCount);
+    result.insert(result.end(), begin(), end());
+    return result;
+}
+
+std::string ActivitySnapshot::toString() const {
+    std::ostringstream output;
+    output << "--- Todo List: " << name << " ---\n";
+
+    if (liveCount == 0) {
+        output << "No activities to display.\n";
+        return output.str();
+    }
+
+    size_t number = 0;
+    for (size_t index : *dueDateOrder) {
+        if (!isLive(index)) continue;
+        output << ++number << ". " << slot(index).toString() << "\n";
+    }
+    return output.str();
+}
+
+// The writers expect contiguous storage, so the live activities are gathered first
+void ActivitySnapshot::saveToFile(const std::string& filename, FileFormat format, SaveMode mode) const {
+    writeActivitiesFile(filename, getActivities(), format, mode);
+}
@@ -0,0 +1,94 @@
+#ifndef ACTIVITYSNAPSHOT_H
+#define ACTIVITYSNAPSHOT_H
+
+#include "Activity.h"
+#include "DueDateIndex.h"
+#include "FileFormat.h"
+#include "LiveSlots.h"
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Immutable copy of a fixed-size run of storage slots (tombstones included, flagged as dead)
+struct ActivityChunk {
+    static constexpr size_t SIZE = 256;
+
+    std::vector<Activity> activities; // Slots [index * SIZE, index * SIZE + activities.size())
+    std::vector<bool> live;           // False for the slots of removed activities
+
+    // Copies the chunk at the given index out of a TodoList's storage
+    static std::shared_ptr<const ActivityChunk> copyFrom(const std::vector<Activity>& storage, const LiveSlots& liveSlots,
+                                                         size_t index);
+};
+
+// Immutable, reference-counted version of a TodoList (see TodoList::snapshot()).
+// Consecutive snapshots share every chunk (and every leaf of the due date order) that did not change between them,
+// so a new version only copies what was edited. A snapshot is never modified once published: any
+// thread may read it, with no lock, while the list keeps changing.
+class ActivitySnapshot {
+private:
+    std::string name;
+    std::vector<std::shared_ptr<const ActivityChunk>> chunks;
+    std::shared_ptr<const DueDateIndex> dueDateOrder; // Slots sorted by due date; may hold dead slots
+    size_t slotCount = 0;
+    size_t liveCount = 0;
+    uint64_t version = 0;
+
+    [[nodiscard]] const Activity& slot(size_t index) const;
+    [[nodiscard]] bool isLive(size_t index) const;
+
+public:
+    ActivitySnapshot(std::string listName, std::vector<std::shared_ptr<const ActivityChunk>> slotChunks,
+                     std::shared_ptr<const DueDateIndex> order, size_t live, uint64_t listVersion);
+
+    // Live activities in list order
+    class iterator {
+    private:
+        const ActivitySnapshot* snapshot = nullptr;
+        size_t current = 0;
+
+        void skip() {
+            while (current < snapshot->slotCount && !snapshot->isLive(current)) ++current;
+        }
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Activity;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Activity*;
+        using reference = const Activity&;
+
+        iterator() = default;
+        iterator(const ActivitySnapshot* owner, size_t position) : snapshot(owner), current(position) { skip(); }
+
+        reference operator*() const { return snapshot->slot(current); }
+        pointer operator->() const { return &snapshot->slot(current); }
+        iterator& operator++() { ++current; skip(); return *this; }
+        iterator operator++(int) { iterator copy = *this; ++*this; return copy; }
+        bool operator==(const iterator& other) const { return current == other.current; }
+        bool operator!=(const iterator& other) const { return current != other.current; }
+    };
+
+    [[nodiscard]] iterator begin() const { return {this, 0}; }
+    [[nodiscard]] iterator end() const { return {this, slotCount}; }
+    [[nodiscard]] size_t size() const { return liveCount; }
+    [[nodiscard]] bool empty() const { return liveCount == 0; }
+
+    [[nodiscard]] const std::string& getName() const { return name; }
+    // Mutation count of the list when the snapshot was taken; snapshots of one list with equal versions are equal
+    [[nodiscard]] uint64_t getVersion() const { return version; }
+    [[nodiscard]] size_t getChunkCount() const { return chunks.size(); }
+    [[nodiscard]] const std::shared_ptr<const ActivityChunk>& getChunk(size_t index) const { return chunks[index]; }
+    [[nodiscard]] const std::shared_ptr<const DueDateIndex>& getDueDateOrder() const { return dueDateOrder; }
+
+    [[nodiscard]] std::vector<Activity> getActivities() const;
+    // Same output as TodoList::toString() at the time of the snapshot
+    [[nodiscard]] std::string toString() const;
+    // Same file as TodoList::saveToFile() at the time of the snapshot; throws std::runtime_error on failure
+    void saveToFile(const std::string& filename, FileFormat format = FileFormat::Text, SaveMode mode = SaveMode::InPlace) const;
+};
+
+#endif
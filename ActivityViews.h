@@ -0,0 +1,226 @@
+#ifndef ACTIVITYVIEWS_H
+#define ACTIVITYVIEWS_H
+
+#include "Activity.h"
+#include "DueDateIndex.h"
+#include "LiveSlots.h"
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+// Non-owning views over the activities stored in a TodoList.
+// They never copy activities; any mutation of the list invalidates them.
+// Slots left behind by removed activities are skipped; the views take a null LiveSlots
+// when the storage holds no such tombstone, which keeps them plain pointer walks.
+
+// View of all activities, in list order
+class ActivitySpan {
+private:
+    const Activity* first = nullptr;
+    const Activity* last = nullptr;
+    const LiveSlots* live = nullptr;
+
+public:
+    class iterator {
+    private:
+        const Activity* base = nullptr;
+        const Activity* current = nullptr;
+        const Activity* last = nullptr;
+        const LiveSlots* live = nullptr;
+
+        void skip() {
+            while (live != nullptr && current != last && !live->isLive(static_cast<size_t>(current - base))) ++current;
+        }
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Activity;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Activity*;
+        using reference = const Activity&;
+
+        iterator() = default;
+        iterator(const Activity* storage, const Activity* position, const Activity* end, const LiveSlots* liveSlots)
+            : base(storage), current(position), last(end), live(liveSlots) { skip(); }
+
+        reference operator*() const { return *current; }
+        pointer operator->() const { return current; }
+        iterator& operator++() { ++current; skip(); return *this; }
+        iterator operator++(int) { iterator copy = *this; ++*this; return copy; }
+        bool operator==(const iterator& other) const { return current == other.current; }
+        bool operator!=(const iterator& other) const { return current != other.current; }
+    };
+
+    ActivitySpan() = default;
+    ActivitySpan(const Activity* begin, const Activity* end, const LiveSlots* liveSlots = nullptr)
+        : first(begin), last(end), live(liveSlots) {}
+
+    [[nodiscard]] iterator begin() const { return {first, first, last, live}; }
+    [[nodiscard]] iterator end() const { return {first, last, last, live}; }
+    [[nodiscard]] size_t size() const { return live != nullptr ? live->liveCount() : static_cast<size_t>(last - first); }
+    [[nodiscard]] bool empty() const { return size() == 0; }
+    // O(1) without tombstones, O(log n) otherwise
+    const Activity& operator[](size_t index) const { return first[live != nullptr ? live->select(index) : index]; }
+};
+
+// View of the activities at a sequence of slots (e.g. a slice of an index)
+class ActivityPositionsView {
+private:
+    const Activity* base = nullptr;
+    const size_t* first = nullptr;
+    const size_t* last = nullptr;
+    const LiveSlots* live = nullptr;
+
+public:
+    class iterator {
+    private:
+        const Activity* base = nullptr;
+        const size_t* current = nullptr;
+        const size_t* last = nullptr;
+        const LiveSlots* live = nullptr;
+
+        void skip() {
+            while (live != nullptr && current != last && !live->isLive(*current)) ++current;
+        }
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Activity;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Activity*;
+        using reference = const Activity&;
+
+        iterator() = default;
+        iterator(const Activity* activities, const size_t* position, const size_t* end, const LiveSlots* liveSlots)
+            : base(activities), current(position), last(end), live(liveSlots) { skip(); }
+
+        reference operator*() const { return base[*current]; }
+        pointer operator->() const { return base + *current; }
+        iterator& operator++() { ++current; skip(); return *this; }
+        iterator operator++(int) { iterator copy = *this; ++*this; return copy; }
+        bool operator==(const iterator& other) const { return current == other.current; }
+        bool operator!=(const iterator& other) const { return current != other.current; }
+        // Returns the 0-based position in the list of the activity this iterator points to
+        [[nodiscard]] size_t position() const { return live != nullptr ? live->rank(*current) : *current; }
+    };
+
+    ActivityPositionsView() = default;
+    ActivityPositionsView(const Activity* activities, const size_t* begin, const size_t* end, const LiveSlots* liveSlots = nullptr)
+        : base(activities), first(begin), last(end), live(liveSlots) {}
+
+    [[nodiscard]] iterator begin() const { return {base, first, last, live}; }
+    [[nodiscard]] iterator end() const { return {base, last, last, live}; }
+    // O(1) without tombstones, otherwise linear in the length of the slice
+    [[nodiscard]] size_t size() const {
+        if (live == nullptr) return static_cast<size_t>(last - first);
+        return static_cast<size_t>(std::distance(begin(), end()));
+    }
+    [[nodiscard]] bool empty() const { return begin() == end(); }
+    const Activity& operator[](size_t index) const {
+        if (live == nullptr) return base[first[index]];
+        return *std::next(begin(), static_cast<std::ptrdiff_t>(index));
+    }
+};
+
+// View of the activities in a range of the due date index, sorted by due date
+class ActivityDueDateView {
+private:
+    const Activity* base = nullptr;
+    DueDateIndex::const_iterator first;
+    DueDateIndex::const_iterator last;
+    const LiveSlots* live = nullptr;
+
+public:
+    class iterator {
+    private:
+        const Activity* base = nullptr;
+        DueDateIndex::const_iterator current;
+        DueDateIndex::const_iterator last;
+        const LiveSlots* live = nullptr;
+
+        void skip() {
+            while (live != nullptr && current != last && !live->isLive(*current)) ++current;
+        }
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Activity;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Activity*;
+        using reference = const Activity&;
+
+        iterator() = default;
+        iterator(const Activity* activities, DueDateIndex::const_iterator position, DueDateIndex::const_iterator end,
+                 const LiveSlots* liveSlots)
+            : base(activities), current(position), last(end), live(liveSlots) { skip(); }
+
+        reference operator*() const { return base[*current]; }
+        pointer operator->() const { return base + *current; }
+        iterator& operator++() { ++current; skip(); return *this; }
+        iterator operator++(int) { iterator copy = *this; ++*this; return copy; }
+        bool operator==(const iterator& other) const { return current == other.current; }
+        bool operator!=(const iterator& other) const { return current != other.current; }
+        // Returns the 0-based position in the list of the activity this iterator points to
+        [[nodiscard]] size_t position() const { return live != nullptr ? live->rank(*current) : *current; }
+    };
+
+    ActivityDueDateView() = default;
+    ActivityDueDateView(const Activity* activities, DueDateIndex::const_iterator begin, DueDateIndex::const_iterator end,
+                        const LiveSlots* liveSlots = nullptr)
+        : base(activities), first(begin), last(end), live(liveSlots) {}
+
+    [[nodiscard]] iterator begin() const { return {base, first, last, live}; }
+    [[nodiscard]] iterator end() const { return {base, last, last, live}; }
+    // Linear in the length of the range
+    [[nodiscard]] size_t size() const { return static_cast<size_t>(std::distance(begin(), end())); }
+    [[nodiscard]] bool empty() const { return begin() == end(); }
+    const Activity& operator[](size_t index) const { return *std::next(begin(), static_cast<std::ptrdiff_t>(index)); }
+};
+
+// Lazily filtered view: the predicate is evaluated while iterating, nothing is collected up front
+template <typename Predicate>
+class FilteredActivityView {
+private:
+    ActivitySpan source;
+    Predicate predicate;
+
+public:
+    class iterator {
+    private:
+        ActivitySpan::iterator current;
+        ActivitySpan::iterator last;
+        const Predicate* predicate = nullptr;
+
+        void skip() {
+            while (current != last && !(*predicate)(*current)) ++current;
+        }
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Activity;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Activity*;
+        using reference = const Activity&;
+
+        iterator() = default;
+        iterator(ActivitySpan::iterator begin, ActivitySpan::iterator end, const Predicate* filter)
+            : current(begin), last(end), predicate(filter) { skip(); }
+
+        reference operator*() const { return *current; }
+        pointer operator->() const { return &*current; }
+        iterator& operator++() { ++current; skip(); return *this; }
+        iterator operator++(int) { iterator copy = *this; ++*this; return copy; }
+        bool operator==(const iterator& other) const { return current == other.current; }
+        bool operator!=(const iterator& other) const { return current != other.current; }
+    };
+
+    FilteredActivityView(ActivitySpan activities, Predicate filter)
+        : source(activities), predicate(std::move(filter)) {}
+
+    [[nodiscard]] iterator begin() const { return {source.begin(), source.end(), &predicate}; }
+    [[nodiscard]] iterator end() const { return {source.end(), source.end(), &predicate}; }
+    [[nodiscard]] bool empty() const { return begin() == end(); }
+};
+
+#endif
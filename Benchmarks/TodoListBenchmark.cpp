@@ -0,0 +1,376 @@
+#include <benchmark/benchmark.h>
+#include "../TodoList.h"
+#include "../Activity.h"
+#include "../ColumnKernels.h"
+#include "../ObserverDispatcher.h"
+#include "../TodoListStore.h"
+#include <chrono>
+#include <atomic>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Builds a list of n activities with distinct names and spread-out due dates
+static std::vector<Activity> makeActivities(size_t n) {
+    std::vector<Activity> activities;
+    activities.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        activities.emplace_back("Task " + std::to_string(i), i % 3 == 0,
+                                static_cast<std::time_t>(1700000000 + (i * 7919) % 100000));
+    }
+    return activities;
+}
+
+static TodoList makeList(size_t n) {
+    TodoList todoList("BenchmarkList");
+    todoList.addActivities(makeActivities(n));
+    return todoList;
+}
+
+// List sizes from 10 to 10M activities
+static void listSizes(benchmark::internal::Benchmark* b) {
+    b->RangeMultiplier(10)->Range(10, 10000000)->Unit(benchmark::kMicrosecond);
+}
+
+static void BM_ActivitySerialize(benchmark::State& state) {
+    Activity activity("Complete the C++ project", true, 1700000000);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(activity.serialize());
+    }
+}
+BENCHMARK(BM_ActivitySerialize);
+
+static void BM_ActivityDeserialize(benchmark::State& state) {
+    const std::string serialized = "Complete the C++ project;1;1700000000";
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Activity::deserialize(serialized));
+    }
+}
+BENCHMARK(BM_ActivityDeserialize);
+
+static void BM_AddActivity(benchmark::State& state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    for (auto _ : state) {
+        state.PauseTiming();
+        TodoList todoList("BenchmarkList");
+        state.ResumeTiming();
+        for (size_t i = 0; i < n; ++i) {
+            todoList.addActivity(Activity("Task", false, static_cast<std::time_t>(i)));
+        }
+        benchmark::DoNotOptimize(todoList.getTotalActivities());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * n));
+}
+BENCHMARK(BM_AddActivity)->Apply(listSizes);
+
+// Removes the first activity (the worst case for a vector) and puts one back outside the timed region
+static void BM_RemoveActivityByIndex(benchmark::State& state) {
+    TodoList todoList = makeList(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        todoList.removeActivity("1", true);
+        state.PauseTiming();
+        todoList.addActivity(Activity("Refill", false, 1700000000));
+        state.ResumeTiming();
+    }
+}
+BENCHMARK(BM_RemoveActivityByIndex)->Apply(listSizes);
+
+static void BM_RemoveActivityByName(benchmark::State& state) {
+    TodoList todoList = makeList(static_cast<size_t>(state.range(0)));
+    const std::string target = "Task 0";
+    for (auto _ : state) {
+        todoList.removeActivity(target, true);
+        state.PauseTiming();
+        todoList.addActivity(Activity(target, false, 1700000000));
+        state.ResumeTiming();
+    }
+}
+BENCHMARK(BM_RemoveActivityByName)->Apply(listSizes);
+
+// Bulk import: one addActivities() call against a batch of single addActivity() calls
+static void BM_AddActivitiesBulk(benchmark::State& state) {
+    const bool bulk = state.range(1) != 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::vector<Activity> activities = makeActivities(static_cast<size_t>(state.range(0)));
+        TodoList todoList("BenchmarkList");
+        state.ResumeTiming();
+        if (bulk) {
+            todoList.addActivities(std::move(activities));
+        } else {
+            TodoList::Batch batch(todoList);
+            for (const Activity& activity : activities) {
+                todoList.addActivity(activity);
+            }
+        }
+    }
+}
+BENCHMARK(BM_AddActivitiesBulk)->ArgsProduct({benchmark::CreateRange(1000, 1000000, 10), {0, 1}})
+    ->Unit(benchmark::kMillisecond);
+
+// Bulk cleanup: removes every completed activity in one pass
+static void BM_RemoveActivitiesWhere(benchmark::State& state) {
+    for (auto _ : state) {
+        state.PauseTiming();
+        TodoList todoList = makeList(static_cast<size_t>(state.range(0)));
+        state.ResumeTiming();
+        benchmark::DoNotOptimize(todoList.removeActivities([](const Activity& a) { return a.isCompleted(); }));
+    }
+}
+BENCHMARK(BM_RemoveActivitiesWhere)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMillisecond);
+
+// Empties a list one positional removal at a time (was quadratic when every removal shifted the vector)
+static void BM_RemoveAllActivities(benchmark::State& state) {
+    for (auto _ : state) {
+        state.PauseTiming();
+        TodoList todoList = makeList(static_cast<size_t>(state.range(0)));
+        std::vector<std::string> positions;
+        for (size_t i = static_cast<size_t>(state.range(0)); i > 0; --i) {
+            positions.push_back(std::to_string((i + 1) / 2)); // Always the middle activity
+        }
+        state.ResumeTiming();
+        for (const std::string& position : positions) {
+            todoList.removeActivity(position, true);
+        }
+    }
+}
+BENCHMARK(BM_RemoveAllActivities)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMillisecond);
+
+static void BM_FindActivitiesByName(benchmark::State& state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    TodoList todoList = makeList(n);
+    const std::string target = "Task " + std::to_string(n / 2);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(todoList.findActivitiesByName(target));
+    }
+}
+BENCHMARK(BM_FindActivitiesByName)->Apply(listSizes);
+
+static void BM_FindActivitiesByDueDate(benchmark::State& state) {
+    TodoList todoList = makeList(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(todoList.findActivitiesByDueDate(1700000000));
+    }
+}
+BENCHMARK(BM_FindActivitiesByDueDate)->Apply(listSizes);
+
+static void BM_ToString(benchmark::State& state) {
+    TodoList todoList = makeList(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(todoList.toString());
+    }
+}
+BENCHMARK(BM_ToString)->Apply(listSizes);
+
+static void BM_SaveToFile(benchmark::State& state) {
+    const auto format = static_cast<FileFormat>(state.range(1));
+    TodoList todoList = makeList(static_cast<size_t>(state.range(0)));
+    const std::string filename = "benchmark_save.tmp";
+    for (auto _ : state) {
+        todoList.saveToFile(filename, format);
+    }
+    std::remove(filename.c_str());
+}
+BENCHMARK(BM_SaveToFile)->ArgsProduct({benchmark::CreateRange(10, 10000000, 10),
+                                       {static_cast<int64_t>(FileFormat::Text), static_cast<int64_t>(FileFormat::Binary)}})
+    ->Unit(benchmark::kMillisecond);
+
+static void BM_LoadFromFile(benchmark::State& state) {
+    const auto format = static_cast<FileFormat>(state.range(1));
+    const std::string filename = "benchmark_load.tmp";
+    makeList(static_cast<size_t>(state.range(0))).saveToFile(filename, format);
+    TodoList todoList("Loaded");
+    for (auto _ : state) {
+        todoList.loadFromFile(filename);
+    }
+    std::remove(filename.c_str());
+}
+BENCHMARK(BM_LoadFromFile)->ArgsProduct({benchmark::CreateRange(10, 10000000, 10),
+                                         {static_cast<int64_t>(FileFormat::Text), static_cast<int64_t>(FileFormat::Binary)}})
+    ->Unit(benchmark::kMillisecond);
+
+// Text load of a 1M-activity file with 1..8 parser threads
+static void BM_LoadFromFileThreads(benchmark::State& state) {
+    const std::string filename = "benchmark_load_threads.tmp";
+    makeList(1000000).saveToFile(filename);
+    TodoList todoList("Loaded");
+    for (auto _ : state) {
+        todoList.loadFromFile(filename, static_cast<unsigned>(state.range(0)));
+    }
+    std::remove(filename.c_str());
+}
+BENCHMARK(BM_LoadFromFileThreads)->RangeMultiplier(2)->Range(1, 8)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// Overhead of the atomic save (temporary file + fsync + rename + directory fsync) over an in-place save
+static void BM_SaveToFileAtomic(benchmark::State& state) {
+    const auto mode = static_cast<SaveMode>(state.range(1));
+    TodoList todoList = makeList(static_cast<size_t>(state.range(0)));
+    const std::string filename = "benchmark_save_atomic.tmp";
+    for (auto _ : state) {
+        todoList.saveToFile(filename, FileFormat::Binary, mode);
+    }
+    std::remove(filename.c_str());
+}
+BENCHMARK(BM_SaveToFileAtomic)->ArgsProduct({benchmark::CreateRange(10, 1000000, 100),
+                                             {static_cast<int64_t>(SaveMode::InPlace), static_cast<int64_t>(SaveMode::Atomic)}})
+    ->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// Column scans on each kernel level: 0 = scalar, 1 = SSE4.2, 2 = AVX2 (clamped to what the CPU supports)
+static void BM_CountOverdueKernel(benchmark::State& state) {
+    TodoList todoList = makeList(static_cast<size_t>(state.range(0)));
+    const KernelLevel original = getKernelLevel();
+    setKernelLevel(static_cast<KernelLevel>(state.range(1)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(todoList.getOverdueActivities(1700050000));
+    }
+    state.SetLabel(getKernelLevel() == KernelLevel::AVX2 ? "avx2" : getKernelLevel() == KernelLevel::SSE42 ? "sse4.2" : "scalar");
+    setKernelLevel(original);
+}
+BENCHMARK(BM_CountOverdueKernel)->ArgsProduct({benchmark::CreateRange(1000, 10000000, 100), {0, 1, 2}})
+    ->Unit(benchmark::kMicrosecond);
+
+static void BM_CountPendingKernel(benchmark::State& state) {
+    TodoList todoList = makeList(static_cast<size_t>(state.range(0)));
+    const KernelLevel original = getKernelLevel();
+    setKernelLevel(static_cast<KernelLevel>(state.range(1)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(todoList.getPendingActivities());
+    }
+    setKernelLevel(original);
+}
+BENCHMARK(BM_CountPendingKernel)->ArgsProduct({benchmark::CreateRange(1000, 10000000, 100), {0, 1, 2}})
+    ->Unit(benchmark::kMicrosecond);
+
+// Read throughput in concurrent mode against the number of reader threads; the second argument
+// adds a background writer that keeps editing the list while the readers run
+static void BM_ConcurrentReads(benchmark::State& state) {
+    static TodoList* todoList = nullptr;
+    static std::atomic<bool> stopWriter{false};
+    static std::thread writer;
+    if (state.thread_index() == 0) {
+        todoList = new TodoList(makeList(100000));
+        todoList->setConcurrentMode(true);
+        if (state.range(0) != 0) {
+            stopWriter = false;
+            writer = std::thread([] {
+                for (size_t i = 0; !stopWriter; ++i) {
+                    todoList->editActivity(std::to_string(i % 100000 + 1), "", true, i % 2 == 0, false, 0);
+                }
+            });
+        }
+    }
+    const std::string target = "Task " + std::to_string(state.thread_index() * 997);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(todoList->findActivitiesByName(target));
+        benchmark::DoNotOptimize(todoList->getPendingActivities());
+    }
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0) {
+        if (writer.joinable()) {
+            stopWriter = true;
+            writer.join();
+        }
+        delete todoList;
+        todoList = nullptr;
+    }
+}
+BENCHMARK(BM_ConcurrentReads)->Arg(0)->Arg(1)->ThreadRange(1, 8)->UseRealTime();
+
+// Cost of publishing a new snapshot after one edit: only the edited chunk and the chunk table are copied
+static void BM_SnapshotAfterEdit(benchmark::State& state) {
+    TodoList todoList = makeList(static_cast<size_t>(state.range(0)));
+    benchmark::DoNotOptimize(todoList.snapshot()); // The first snapshot copies everything
+    size_t i = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        todoList.editActivity(std::to_string(i % todoList.getTotalActivities() + 1), "", true, i % 2 == 0, false, 0);
+        ++i;
+        state.ResumeTiming();
+        benchmark::DoNotOptimize(todoList.snapshot());
+    }
+}
+BENCHMARK(BM_SnapshotAfterEdit)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+
+// Observer that spends a fixed time in every callback, like a console render
+class BusyObserver : public Observer {
+public:
+    void update() override {
+        const auto until = std::chrono::steady_clock::now() + std::chrono::microseconds(20);
+        while (std::chrono::steady_clock::now() < until) {}
+    }
+};
+
+// addActivity latency with a 20 us observer, called inline (0) or through a dispatcher (1)
+static void BM_AddActivityWithSlowObserver(benchmark::State& state) {
+    auto dispatcher = std::make_shared<ObserverDispatcher>(1 << 20);
+    TodoList todoList("BenchmarkList");
+    BusyObserver observer;
+    todoList.addObserver(&observer);
+    if (state.range(0) != 0) todoList.setDispatcher(dispatcher);
+    for (auto _ : state) {
+        todoList.addActivity(Activity("Task", false, 1700000000));
+    }
+    todoList.removeObserver(&observer); // Drains the queue before the observer goes away
+}
+BENCHMARK(BM_AddActivityWithSlowObserver)->Arg(0)->Arg(1)->Iterations(20000)->Unit(benchmark::kMicrosecond);
+
+// Lookups by name among 10k lists, from 1 to 8 threads
+static void BM_StoreFind(benchmark::State& state) {
+    static TodoListStore* store = nullptr;
+    if (state.thread_index() == 0) {
+        store = new TodoListStore();
+        for (int i = 0; i < 10000; ++i) store->create("List " + std::to_string(i));
+    }
+    size_t i = static_cast<size_t>(state.thread_index()) * 7919;
+    std::vector<std::string> names;
+    for (int n = 0; n < 1024; ++n) names.push_back("List " + std::to_string((i + n * 31) % 10000));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(store->find(names[i++ % names.size()]));
+    }
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0) {
+        delete store;
+        store = nullptr;
+    }
+}
+BENCHMARK(BM_StoreFind)->ThreadRange(1, 8)->UseRealTime();
+
+// Renames a list holding n activities back and forth: only the handle moves
+static void BM_StoreRename(benchmark::State& state) {
+    TodoListStore store;
+    store.create("A")->addActivities(makeActivities(static_cast<size_t>(state.range(0))));
+    bool atA = true;
+    for (auto _ : state) {
+        store.rename(atA ? "A" : "B", atA ? "B" : "A");
+        atA = !atA;
+    }
+}
+BENCHMARK(BM_StoreRename)->RangeMultiplier(100)->Range(10, 1000000);
+
+// Skewed access to 200 lists of 500 activities with room for range(0)% of them in memory:
+// every miss is a reload from the paging file (plus a save when the evicted list changed)
+static void BM_StorePagedAccess(benchmark::State& state) {
+    const std::string directory = "benchmark_paging";
+    {
+        TodoListStore store;
+        size_t perList = 0;
+        for (int l = 0; l < 200; ++l) {
+            auto list = store.create("List " + std::to_string(l));
+            list->addActivities(makeActivities(500));
+            perList = list->getMemoryUsage();
+        }
+        store.setMemoryBudget(perList * 2 * static_cast<size_t>(state.range(0)), directory);
+        size_t i = 0;
+        for (auto _ : state) {
+            // Half of the accesses go to the first 10 lists
+            const size_t l = (i % 2 == 0) ? (i / 2) % 10 : (i * 7919) % 200;
+            ++i;
+            store.find("List " + std::to_string(l))->markActivityAsCompleted(std::to_string(i % 500 + 1));
+        }
+        state.counters["loaded"] = static_cast<double>(store.getLoadedCount());
+    }
+    std::filesystem::remove(directory); // Empty once the store has deleted its paging files
+}
+BENCHMARK(BM_StorePagedAccess)->Arg(5)->Arg(25)->Arg(100)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,166 @@
+#include "ColumnKernels.h"
+#include <algorithm>
+#include <atomic>
+#include <bitset>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define TODOLIST_HAS_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+// ---- Scalar kernels (reference implementations and fallback) ----
+
+static size_t countSetBitsScalar(const uint64_t* words, size_t wordCount) {
+    size_t total = 0;
+    for (size_t i = 0; i < wordCount; ++i) {
+        total += std::bitset<64>(words[i]).count();
+    }
+    return total;
+}
+
+static size_t countOverdueScalar(const int64_t* dueDates, const uint64_t* completedBits, size_t count, int64_t now) {
+    size_t overdue = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const bool completed = (completedBits[i / 64] >> (i % 64)) & 1U;
+        overdue += (dueDates[i] < now) & !completed;
+    }
+    return overdue;
+}
+
+#ifdef TODOLIST_HAS_X86_KERNELS
+
+// ---- SSE4.2 kernels: two dates per compare ----
+
+__attribute__((target("sse4.2,popcnt")))
+static size_t countSetBitsSSE42(const uint64_t* words, size_t wordCount) {
+    size_t total = 0;
+    for (size_t i = 0; i < wordCount; ++i) {
+        total += static_cast<size_t>(__builtin_popcountll(words[i]));
+    }
+    return total;
+}
+
+__attribute__((target("sse4.2,popcnt")))
+static size_t countOverdueSSE42(const int64_t* dueDates, const uint64_t* completedBits, size_t count, int64_t now) {
+    const __m128i limit = _mm_set1_epi64x(now);
+    size_t overdue = 0;
+    size_t i = 0;
+    // One completion word covers 64 dates: 32 compares of two lanes each
+    for (; i + 64 <= count; i += 64) {
+        uint64_t dueMask = 0;
+        for (size_t j = 0; j < 64; j += 2) {
+            const __m128i dates = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dueDates + i + j));
+            const auto lanes = static_cast<uint64_t>(_mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(limit, dates))));
+            dueMask |= lanes << j;
+        }
+        overdue += static_cast<size_t>(__builtin_popcountll(dueMask & ~completedBits[i / 64]));
+    }
+    for (; i < count; ++i) {
+        const bool completed = (completedBits[i / 64] >> (i % 64)) & 1U;
+        overdue += (dueDates[i] < now) & !completed;
+    }
+    return overdue;
+}
+
+// ---- AVX2 kernels: four dates per compare ----
+
+// Popcount of 256 bits at a time with the nibble lookup table method
+__attribute__((target("avx2,popcnt")))
+static size_t countSetBitsAVX2(const uint64_t* words, size_t wordCount) {
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i lowNibbles = _mm256_set1_epi8(0x0F);
+    __m256i totals = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 4 <= wordCount; i += 4) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + i));
+        const __m256i low = _mm256_and_si256(v, lowNibbles);
+        const __m256i high = _mm256_and_si256(_mm256_srli_epi16(v, 4), lowNibbles);
+        const __m256i bytes = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, low), _mm256_shuffle_epi8(lookup, high));
+        totals = _mm256_add_epi64(totals, _mm256_sad_epu8(bytes, _mm256_setzero_si256()));
+    }
+    alignas(32) uint64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), totals);
+    size_t total = static_cast<size_t>(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+    for (; i < wordCount; ++i) {
+        total += static_cast<size_t>(__builtin_popcountll(words[i]));
+    }
+    return total;
+}
+
+__attribute__((target("avx2,popcnt")))
+static size_t countOverdueAVX2(const int64_t* dueDates, const uint64_t* completedBits, size_t count, int64_t now) {
+    const __m256i limit = _mm256_set1_epi64x(now);
+    size_t overdue = 0;
+    size_t i = 0;
+    for (; i + 64 <= count; i += 64) {
+        uint64_t dueMask = 0;
+        for (size_t j = 0; j < 64; j += 4) {
+            const __m256i dates = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dueDates + i + j));
+            const auto lanes = static_cast<uint64_t>(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(limit, dates))));
+            dueMask |= lanes << j;
+        }
+        overdue += static_cast<size_t>(__builtin_popcountll(dueMask & ~completedBits[i / 64]));
+    }
+    for (; i < count; ++i) {
+        const bool completed = (completedBits[i / 64] >> (i % 64)) & 1U;
+        overdue += (dueDates[i] < now) & !completed;
+    }
+    return overdue;
+}
+
+#endif
+
+// ---- Runtime dispatch ----
+
+struct KernelTable {
+    KernelLevel level;
+    size_t (*countSetBits)(const uint64_t*, size_t);
+    size_t (*countOverdue)(const int64_t*, const uint64_t*, size_t, int64_t);
+};
+
+static const KernelTable scalarKernels{KernelLevel::Scalar, countSetBitsScalar, countOverdueScalar};
+#ifdef TODOLIST_HAS_X86_KERNELS
+static const KernelTable sse42Kernels{KernelLevel::SSE42, countSetBitsSSE42, countOverdueSSE42};
+static const KernelTable avx2Kernels{KernelLevel::AVX2, countSetBitsAVX2, countOverdueAVX2};
+#endif
+
+KernelLevel getSupportedKernelLevel() {
+#ifdef TODOLIST_HAS_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt")) return KernelLevel::AVX2;
+    if (__builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("popcnt")) return KernelLevel::SSE42;
+#endif
+    return KernelLevel::Scalar;
+}
+
+static const KernelTable* tableFor(KernelLevel level) {
+#ifdef TODOLIST_HAS_X86_KERNELS
+    if (level == KernelLevel::AVX2) return &avx2Kernels;
+    if (level == KernelLevel::SSE42) return &sse42Kernels;
+#endif
+    (void)level;
+    return &scalarKernels;
+}
+
+// Chosen once on first use; setKernelLevel() may override it while other threads dispatch through it
+static std::atomic<const KernelTable*>& activeKernels() {
+    static std::atomic<const KernelTable*> active{tableFor(getSupportedKernelLevel())};
+    return active;
+}
+
+KernelLevel getKernelLevel() {
+    return activeKernels().load(std::memory_order_acquire)->level;
+}
+
+void setKernelLevel(KernelLevel level) {
+    activeKernels().store(tableFor(std::min(level, getSupportedKernelLevel())), std::memory_order_release);
+}
+
+size_t countSetBits(const uint64_t* words, size_t wordCount) {
+    return activeKernels().load(std::memory_order_acquire)->countSetBits(words, wordCount);
+}
+
+size_t countOverdue(const int64_t* dueDates, const uint64_t* completedBits, size_t count, int64_t now) {
+    return activeKernels().load(std::memory_order_acquire)->countOverdue(dueDates, completedBits, count, now);
+}
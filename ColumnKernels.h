@@ -0,0 +1,29 @@
+#ifndef COLUMNKERNELS_H
+#define COLUMNKERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Scan kernels over the packed columns of ActivityColumns.
+// Each kernel has a scalar version and, on x86 with GCC/Clang, SSE4.2 and AVX2 versions;
+// the best one supported by the CPU is picked at runtime.
+
+enum class KernelLevel {
+    Scalar,
+    SSE42,
+    AVX2
+};
+
+// Returns the instruction set the kernels currently use
+KernelLevel getKernelLevel();
+// Returns the best instruction set supported by this CPU
+KernelLevel getSupportedKernelLevel();
+// Selects an instruction set (clamped to what the CPU supports), mainly for tests and benchmarks
+void setKernelLevel(KernelLevel level);
+
+// Number of set bits in words[0, wordCount)
+size_t countSetBits(const uint64_t* words, size_t wordCount);
+// Number of entries that are not completed and due strictly before now
+size_t countOverdue(const int64_t* dueDates, const uint64_t* completedBits, size_t count, int64_t now);
+
+#endif
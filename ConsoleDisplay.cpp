@@ -0,0 +1,103 @@
+#include "ConsoleDisplay.h"
+
+ConsoleDisplay::ConsoleDisplay(TodoList& list, DisplayMode displayMode, std::chrono::milliseconds throttle, std::ostream& output)
+    : todoList(list), out(output), mode(displayMode), minInterval(throttle) {
+    todoList.addObserver(this); // Register this class as an observer
+}
+
+ConsoleDisplay::~ConsoleDisplay() {
+    todoList.removeObserver(this); // Unregister observer when destroyed
+}
+
+// Legacy notification without details: treat it as a reload
+void ConsoleDisplay::update() {
+    onChange(ChangeEvent{});
+}
+
+void ConsoleDisplay::onChange(const ChangeEvent& event) {
+    if (mode == DisplayMode::Full) {
+        if (!canRender()) {
+            ++pendingChanges;
+            return;
+        }
+        renderFull();
+        return;
+    }
+
+    // Events carry the activity before and after the change, so a line costs O(1) whatever the list size
+    std::string line = describeChange(event);
+    if (event.type == ChangeType::Reloaded) {
+        pendingReload = true;
+    }
+
+    if (!canRender()) {
+        ++pendingChanges;
+        return;
+    }
+
+    if (pendingReload) {
+        renderFull();
+        return;
+    }
+
+    if (!line.empty() || pendingChanges > 0) {
+        out << "\nTodo List Updated:\n";
+        if (pendingChanges > 0) {
+            out << "(" << pendingChanges << " earlier change(s) not shown)\n";
+        }
+        out << line;
+        markRendered();
+    }
+}
+
+void ConsoleDisplay::flush() {
+    if (pendingChanges == 0 && !pendingReload) return;
+    if (mode == DisplayMode::Full || pendingReload) {
+        renderFull();
+        return;
+    }
+    out << "\nTodo List Updated:\n(" << pendingChanges << " change(s) not shown)\n";
+    markRendered();
+}
+
+// Lines are prefixed with "+" (added), "-" (removed) or "~" (changed). They carry no activity number:
+// the full view numbers activities by due date, which an event alone cannot tell.
+std::string ConsoleDisplay::describeChange(const ChangeEvent& event) {
+    switch (event.type) {
+        case ChangeType::Added:
+            return "+ " + event.newValue->toString() + "\n";
+        case ChangeType::Removed:
+            return "- " + event.oldValue->toString() + "\n";
+        case ChangeType::Edited:
+        case ChangeType::Completed: {
+            std::string rendered = event.newValue->toString();
+            if (rendered == event.oldValue->toString()) {
+                return ""; // e.g. completing an activity that was already done
+            }
+            return "~ " + rendered + "\n";
+        }
+        case ChangeType::Renamed:
+            return "--- Todo List renamed: " + event.oldName + " -> " + event.newName + " ---\n";
+        case ChangeType::Reloaded:
+            break;
+    }
+    return "";
+}
+
+bool ConsoleDisplay::canRender() const {
+    return !hasRendered || minInterval.count() == 0 ||
+           std::chrono::steady_clock::now() - lastRender >= minInterval;
+}
+
+void ConsoleDisplay::renderFull() {
+    out << "\nTodo List Updated:\n";
+    out << todoList.toString();
+    markRendered();
+}
+
+void ConsoleDisplay::markRendered() {
+    lastRender = std::chrono::steady_clock::now();
+    hasRendered = true;
+    pendingChanges = 0;
+    pendingReload = false;
+}
@@ -3,25 +3,45 @@
 
 #include "Observer.h"
 #include "TodoList.h"
+#include <chrono>
 #include <iostream>
+#include <string>
+
+// How ConsoleDisplay reacts to a change
+enum class DisplayMode {
+    Full,       // Prints the whole list after every change
+    Incremental // Prints only the lines that changed
+};
 
 class ConsoleDisplay : public Observer {
 private:
     TodoList& todoList; // Reference to TodoList
+    std::ostream& out;
+    DisplayMode mode;
+    std::chrono::milliseconds minInterval; // Minimum time between two renders (0 = no throttling)
+    std::chrono::steady_clock::time_point lastRender;
+    bool hasRendered = false;
+    size_t pendingChanges = 0; // Changes absorbed by the throttle since the last render
+    bool pendingReload = false; // Whether one of them requires a full render
+
+    // Returns the line to print for the event, or an empty string if nothing visible changed
+    static std::string describeChange(const ChangeEvent& event);
+    // Whether the throttle allows rendering now
+    bool canRender() const;
+    void renderFull();
+    void markRendered();
 
 public:
-    explicit ConsoleDisplay(TodoList& list) : todoList(list) {
-        todoList.addObserver(this); // Register this class as an observer
-    }
-
-    ~ConsoleDisplay() override {
-        todoList.removeObserver(this); // Unregister observer when destroyed
-    }
-
-    void update() override {
-        std::cout << "\nTodo List Updated:\n";
-        std::cout << todoList.toString();
-    }
+    explicit ConsoleDisplay(TodoList& list, DisplayMode displayMode = DisplayMode::Full,
+                            std::chrono::milliseconds throttle = std::chrono::milliseconds(0),
+                            std::ostream& output = std::cout);
+    ~ConsoleDisplay() override;
+
+    void update() override;
+    void onChange(const ChangeEvent& event) override;
+
+    // Emits whatever the throttle held back
+    void flush();
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,171 @@
+#include "DueDateIndex.h"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+
+// First offset in a leaf whose (due date, slot) is not less than the key
+static size_t lowerOffset(const DueDateLeaf& leaf, std::time_t dueDate, size_t slot) {
+    size_t low = 0;
+    size_t high = leaf.slots.size();
+    while (low < high) {
+        const size_t middle = low + (high - low) / 2;
+        if (std::make_pair(leaf.dueDates[middle], leaf.slots[middle]) < std::make_pair(dueDate, slot)) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+uint64_t DueDateIndex::newEdition() {
+    static std::atomic<uint64_t> next{1};
+    return next.fetch_add(1, std::memory_order_relaxed);
+}
+
+DueDateIndex::DueDateIndex(const DueDateIndex& other) : leaves(other.leaves), count(other.count) {
+    other.edition = newEdition();
+}
+
+DueDateIndex& DueDateIndex::operator=(const DueDateIndex& other) {
+    if (this != &other) {
+        leaves = other.leaves;
+        count = other.count;
+        edition = newEdition();
+        other.edition = newEdition();
+    }
+    return *this;
+}
+
+std::shared_ptr<DueDateLeaf> DueDateIndex::newLeaf() const {
+    auto leaf = std::make_shared<DueDateLeaf>();
+    leaf->dueDates.reserve(LEAF_SIZE + 1);
+    leaf->slots.reserve(LEAF_SIZE + 1);
+    leaf->edition = edition;
+    return leaf;
+}
+
+DueDateLeaf& DueDateIndex::writableLeaf(size_t leaf) {
+    if (leaves[leaf]->edition != edition) {
+        auto copy = newLeaf();
+        copy->dueDates = leaves[leaf]->dueDates;
+        copy->slots = leaves[leaf]->slots;
+        leaves[leaf] = std::move(copy);
+    }
+    return *leaves[leaf];
+}
+
+void DueDateIndex::clear() {
+    leaves.clear();
+    count = 0;
+}
+
+// Leaves start three quarters full, so the first inserts after a rebuild do not split them all
+void DueDateIndex::assign(const std::vector<Entry>& entries) {
+    constexpr size_t FILL = LEAF_SIZE * 3 / 4;
+    clear();
+    leaves.reserve((entries.size() + FILL - 1) / FILL);
+    for (size_t first = 0; first < entries.size(); first += FILL) {
+        const size_t last = std::min(first + FILL, entries.size());
+        auto leaf = newLeaf();
+        for (size_t i = first; i < last; ++i) {
+            leaf->dueDates.push_back(entries[i].first);
+            leaf->slots.push_back(entries[i].second);
+        }
+        leaves.push_back(std::move(leaf));
+    }
+    count = entries.size();
+}
+
+size_t DueDateIndex::leafFor(std::time_t dueDate, size_t slot) const {
+    size_t low = 0;
+    size_t high = leaves.size();
+    while (low < high) {
+        const size_t middle = low + (high - low) / 2;
+        const DueDateLeaf& leaf = *leaves[middle];
+        if (std::make_pair(leaf.dueDates.back(), leaf.slots.back()) < std::make_pair(dueDate, slot)) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+void DueDateIndex::insert(std::time_t dueDate, size_t slot) {
+    if (leaves.empty()) {
+        assign({Entry(dueDate, slot)});
+        return;
+    }
+    // Past the last entry: append to the last leaf
+    const size_t leaf = std::min(leafFor(dueDate, slot), leaves.size() - 1);
+    DueDateLeaf& target = writableLeaf(leaf);
+    const auto offset = static_cast<std::ptrdiff_t>(lowerOffset(target, dueDate, slot));
+    target.dueDates.insert(target.dueDates.begin() + offset, dueDate);
+    target.slots.insert(target.slots.begin() + offset, slot);
+    ++count;
+    if (target.slots.size() > LEAF_SIZE) {
+        splitLeaf(leaf);
+    }
+}
+
+void DueDateIndex::merge(const std::vector<Entry>& entries) {
+    std::vector<Entry> merged;
+    merged.reserve(count + entries.size());
+    auto next = entries.begin();
+    for (auto it = begin(); it != end(); ++it) {
+        const Entry current(it.dueDate(), *it);
+        for (; next != entries.end() && *next < current; ++next) {
+            merged.push_back(*next);
+        }
+        merged.push_back(current);
+    }
+    merged.insert(merged.end(), next, entries.end());
+    assign(merged);
+}
+
+// Moves the upper half of a leaf into a new leaf right after it
+void DueDateIndex::splitLeaf(size_t leaf) {
+    DueDateLeaf& full = writableLeaf(leaf);
+    const auto half = static_cast<std::ptrdiff_t>(full.slots.size() / 2);
+    auto upper = newLeaf();
+    upper->dueDates.assign(full.dueDates.begin() + half, full.dueDates.end());
+    upper->slots.assign(full.slots.begin() + half, full.slots.end());
+    full.dueDates.erase(full.dueDates.begin() + half, full.dueDates.end());
+    full.slots.erase(full.slots.begin() + half, full.slots.end());
+    leaves.insert(leaves.begin() + static_cast<std::ptrdiff_t>(leaf) + 1, std::move(upper));
+}
+
+// An emptied leaf is dropped, and one that falls under a quarter full is merged into its successor when they fit
+void DueDateIndex::erase(std::time_t dueDate, size_t slot) {
+    const size_t leaf = leafFor(dueDate, slot);
+    assert(leaf < leaves.size());
+    DueDateLeaf& target = writableLeaf(leaf);
+    const auto offset = static_cast<std::ptrdiff_t>(lowerOffset(target, dueDate, slot));
+    assert(target.slots[static_cast<size_t>(offset)] == slot);
+    target.dueDates.erase(target.dueDates.begin() + offset);
+    target.slots.erase(target.slots.begin() + offset);
+    --count;
+
+    if (target.slots.empty()) {
+        leaves.erase(leaves.begin() + static_cast<std::ptrdiff_t>(leaf));
+    } else if (target.slots.size() < LEAF_SIZE / 4 && leaf + 1 < leaves.size() &&
+               target.slots.size() + leaves[leaf + 1]->slots.size() <= LEAF_SIZE) {
+        const DueDateLeaf& next = *leaves[leaf + 1];
+        target.dueDates.insert(target.dueDates.end(), next.dueDates.begin(), next.dueDates.end());
+        target.slots.insert(target.slots.end(), next.slots.begin(), next.slots.end());
+        leaves.erase(leaves.begin() + static_cast<std::ptrdiff_t>(leaf) + 1);
+    }
+}
+
+DueDateIndex::const_iterator DueDateIndex::lowerBound(std::time_t dueDate, size_t slot) const {
+    const size_t leaf = leafFor(dueDate, slot);
+    if (leaf == leaves.size()) return end();
+    return {leaves.data(), leaf, lowerOffset(*leaves[leaf], dueDate, slot)};
+}
+
+// Every leaf reserves room for LEAF_SIZE + 1 entries, so this is O(1)
+size_t DueDateIndex::getMemoryUsage() const {
+    constexpr size_t LEAF_BYTES = sizeof(DueDateLeaf) + (LEAF_SIZE + 1) * (sizeof(std::time_t) + sizeof(size_t));
+    return leaves.capacity() * sizeof(std::shared_ptr<DueDateLeaf>) + leaves.size() * LEAF_BYTES;
+}
@@ -0,0 +1,106 @@
+#ifndef DUEDATEINDEX_H
+#define DUEDATEINDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// A run of consecutive entries of a DueDateIndex, sorted by (due date, slot), as two parallel columns
+struct DueDateLeaf {
+    std::vector<std::time_t> dueDates;
+    std::vector<size_t> slots;
+    uint64_t edition = 0; // Edition of the only index allowed to change it
+};
+
+// Storage slots ordered by (due date, slot). The entries are split into sorted leaves of at most LEAF_SIZE,
+// found by a binary search over the leaves, so an insert or erase only shifts the entries of one leaf:
+// O(log n + LEAF_SIZE). A full leaf splits in two, which shifts the leaf pointers once every LEAF_SIZE / 2 inserts.
+// Copies share the leaves (copy-on-write): copying moves both indexes to new editions, and an index copies a leaf
+// stamped with another edition before changing it, so a copy only costs the leaf pointers and never sees later changes.
+class DueDateIndex {
+public:
+    static constexpr size_t LEAF_SIZE = 256;
+
+    using Entry = std::pair<std::time_t, size_t>; // (due date, slot)
+
+    // Walks the slots in order; invalidated by any change to the index
+    class const_iterator {
+    private:
+        const std::shared_ptr<DueDateLeaf>* leaves = nullptr;
+        size_t leaf = 0;
+        size_t offset = 0;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = size_t;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const size_t*;
+        using reference = const size_t&;
+
+        const_iterator() = default;
+        const_iterator(const std::shared_ptr<DueDateLeaf>* leafArray, size_t leafIndex, size_t leafOffset)
+            : leaves(leafArray), leaf(leafIndex), offset(leafOffset) {}
+
+        reference operator*() const { return leaves[leaf]->slots[offset]; }
+        // The due date the entry is sorted by
+        [[nodiscard]] std::time_t dueDate() const { return leaves[leaf]->dueDates[offset]; }
+        const_iterator& operator++() {
+            if (++offset == leaves[leaf]->slots.size()) {
+                ++leaf;
+                offset = 0;
+            }
+            return *this;
+        }
+        const_iterator operator++(int) { const_iterator copy = *this; ++*this; return copy; }
+        bool operator==(const const_iterator& other) const { return leaf == other.leaf && offset == other.offset; }
+        bool operator!=(const const_iterator& other) const { return !(*this == other); }
+    };
+
+private:
+    std::vector<std::shared_ptr<DueDateLeaf>> leaves; // Never empty ones
+    size_t count = 0;
+    // Changed by copying from this index; only read by the (exclusive) writers of the index
+    mutable uint64_t edition = newEdition();
+
+    [[nodiscard]] static uint64_t newEdition();
+    // A new, empty leaf owned by this index
+    [[nodiscard]] std::shared_ptr<DueDateLeaf> newLeaf() const;
+    // The leaf, first copied if it is shared with another index
+    DueDateLeaf& writableLeaf(size_t leaf);
+
+    // The leaf that holds (or would hold) the key: the first one whose last entry is not less than it
+    [[nodiscard]] size_t leafFor(std::time_t dueDate, size_t slot) const;
+    void splitLeaf(size_t leaf);
+
+public:
+    DueDateIndex() = default;
+    DueDateIndex(const DueDateIndex& other);
+    DueDateIndex& operator=(const DueDateIndex& other);
+    DueDateIndex(DueDateIndex&& other) noexcept = default;
+    DueDateIndex& operator=(DueDateIndex&& other) noexcept = default;
+
+    void clear();
+    // Replaces the content with sorted entries
+    void assign(const std::vector<Entry>& entries);
+    void insert(std::time_t dueDate, size_t slot);
+    // Adds sorted entries in one linear pass over the index
+    void merge(const std::vector<Entry>& entries);
+    // Removes an entry, which must be present with this due date
+    void erase(std::time_t dueDate, size_t slot);
+
+    // Returns the first entry whose (due date, slot) is not less than the given key
+    [[nodiscard]] const_iterator lowerBound(std::time_t dueDate, size_t slot = 0) const;
+    [[nodiscard]] const_iterator begin() const { return {leaves.data(), 0, 0}; }
+    [[nodiscard]] const_iterator end() const { return {leaves.data(), leaves.size(), 0}; }
+    [[nodiscard]] size_t size() const { return count; }
+    [[nodiscard]] bool empty() const { return count == 0; }
+    [[nodiscard]] size_t getMemoryUsage() const;
+    [[nodiscard]] size_t getLeafCount() const { return leaves.size(); }
+    [[nodiscard]] const DueDateLeaf* getLeaf(size_t index) const { return leaves[index].get(); }
+};
+
+#endif
@@ -0,0 +1,370 @@
+#include "FileFormat.h"
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <exception>
+#include <string>
+#include <thread>
+#include <cerrno>
+#include <cstdio>
+#include <random>
+#include <filesystem>
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define TODOLIST_HAS_FSYNC 1
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Detects the format from the magic bytes, leaving the stream position untouched
+FileFormat detectFileFormat(std::istream& in) {
+    char magic[sizeof(BINARY_FORMAT_MAGIC)] = {};
+    const std::streampos start = in.tellg();
+    in.read(magic, sizeof(magic));
+    const bool isBinary = in.gcount() == sizeof(magic) &&
+                          std::memcmp(magic, BINARY_FORMAT_MAGIC, sizeof(magic)) == 0;
+    in.clear();
+    in.seekg(start);
+    return isBinary ? FileFormat::Binary : FileFormat::Text;
+}
+
+// Activities serialized by one thread before the buffers are flushed to the stream
+constexpr size_t SERIALIZE_BLOCK_SIZE = 16 * 1024;
+
+static void serializeBlock(const Activity* data, size_t begin, size_t end, const LiveSlots* live, std::string& buffer) {
+    buffer.clear(); // Keeps the capacity reached in earlier rounds
+    for (size_t i = begin; i < end; ++i) {
+        if (live != nullptr && !live->isLive(i)) continue;
+        data[i].appendSerialized(buffer);
+        buffer += '\n';
+    }
+}
+
+// Writes one serialized activity per line. Each round, every thread serializes one block into its
+// own buffer; the buffers are then written in order with one large write each.
+void writeTextActivities(std::ostream& out, const std::vector<Activity>& activities, unsigned threads, const LiveSlots* live) {
+    const size_t blockCount = (activities.size() + SERIALIZE_BLOCK_SIZE - 1) / SERIALIZE_BLOCK_SIZE;
+    const size_t workerCount = std::max<size_t>(1, std::min<size_t>(threads, blockCount));
+    std::vector<std::string> buffers(workerCount);
+    const Activity* data = activities.data();
+
+    for (size_t firstBlock = 0; firstBlock < blockCount; firstBlock += workerCount) {
+        const size_t roundBlocks = std::min(workerCount, blockCount - firstBlock);
+        auto serialize = [&](size_t i) {
+            const size_t begin = (firstBlock + i) * SERIALIZE_BLOCK_SIZE;
+            const size_t end = std::min(begin + SERIALIZE_BLOCK_SIZE, activities.size());
+            serializeBlock(data, begin, end, live, buffers[i]);
+        };
+
+        std::vector<std::thread> workers;
+        workers.reserve(roundBlocks - 1);
+        for (size_t i = 1; i < roundBlocks; ++i) {
+            workers.emplace_back(serialize, i);
+        }
+        serialize(0);
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+
+        for (size_t i = 0; i < roundBlocks; ++i) {
+            out.write(buffers[i].data(), static_cast<std::streamsize>(buffers[i].size()));
+        }
+    }
+}
+
+// Writes the header followed by the due date, id, completion and description columns
+void writeBinaryActivities(std::ostream& out, const std::vector<Activity>& activities, const LiveSlots* live) {
+    const uint64_t count = live != nullptr ? live->liveCount() : activities.size();
+
+    BinaryFileHeader header{};
+    std::memcpy(header.magic, BINARY_FORMAT_MAGIC, sizeof(header.magic));
+    header.version = BINARY_FORMAT_VERSION;
+    header.count = count;
+
+    std::vector<int64_t> dueDates(count);
+    std::vector<uint64_t> ids(count);
+    std::vector<uint64_t> completedBits((count + 63) / 64, 0);
+    std::vector<uint64_t> offsets(count + 1, 0);
+    for (uint64_t slot = 0, i = 0; i < count; ++slot) {
+        if (live != nullptr && !live->isLive(slot)) continue;
+        const Activity& activity = activities[slot];
+        dueDates[i] = static_cast<int64_t>(activity.getDueDate());
+        ids[i] = activity.getId();
+        if (activity.isCompleted()) {
+            completedBits[i / 64] |= uint64_t{1} << (i % 64);
+        }
+        offsets[i + 1] = offsets[i] + activity.getDescription().size();
+        ++i;
+    }
+
+    std::string blob;
+    blob.reserve(offsets[count]);
+    for (size_t slot = 0; slot < activities.size(); ++slot) {
+        if (live != nullptr && !live->isLive(slot)) continue;
+        blob += activities[slot].getDescription();
+    }
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(dueDates.data()), static_cast<std::streamsize>(dueDates.size() * sizeof(int64_t)));
+    out.write(reinterpret_cast<const char*>(ids.data()), static_cast<std::streamsize>(ids.size() * sizeof(uint64_t)));
+    out.write(reinterpret_cast<const char*>(completedBits.data()), static_cast<std::streamsize>(completedBits.size() * sizeof(uint64_t)));
+    out.write(reinterpret_cast<const char*>(offsets.data()), static_cast<std::streamsize>(offsets.size() * sizeof(uint64_t)));
+    out.write(blob.data(), static_cast<std::streamsize>(blob.size()));
+}
+
+// Reads one activity per line, tolerating Windows line endings
+std::vector<Activity> readTextActivities(std::istream& in) {
+    std::vector<Activity> activities;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        activities.push_back(Activity::deserialize(line));
+    }
+    return activities;
+}
+
+// Chunks smaller than this are not worth a thread of their own
+constexpr size_t MIN_PARALLEL_CHUNK_BYTES = 64 * 1024;
+
+// Parses every line of a newline-aligned chunk, tolerating Windows line endings
+static void parseTextChunk(std::string_view chunk, std::vector<Activity>& out) {
+    size_t start = 0;
+    while (start < chunk.size()) {
+        size_t end = chunk.find('\n', start);
+        if (end == std::string_view::npos) end = chunk.size();
+        std::string_view line = chunk.substr(start, end - start);
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        out.push_back(Activity::deserialize(line));
+        start = end + 1;
+    }
+}
+
+std::vector<Activity> parseTextActivities(std::string_view text, unsigned threads) {
+    const size_t maxChunks = text.size() / MIN_PARALLEL_CHUNK_BYTES + 1;
+    const size_t chunkCount = std::max<size_t>(1, std::min<size_t>(threads, maxChunks));
+
+    // Chunk boundaries are moved forward to the next line start, so no line is split
+    std::vector<size_t> bounds(chunkCount + 1, text.size());
+    bounds[0] = 0;
+    for (size_t i = 1; i < chunkCount; ++i) {
+        size_t target = std::max(bounds[i - 1], text.size() / chunkCount * i);
+        size_t newline = text.find('\n', target);
+        bounds[i] = newline == std::string_view::npos ? text.size() : newline + 1;
+    }
+
+    std::vector<std::vector<Activity>> parts(chunkCount);
+    std::vector<std::exception_ptr> errors(chunkCount);
+    auto parse = [&](size_t i) {
+        try {
+            parseTextChunk(text.substr(bounds[i], bounds[i + 1] - bounds[i]), parts[i]);
+        } catch (...) {
+            errors[i] = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(chunkCount - 1);
+    for (size_t i = 1; i < chunkCount; ++i) {
+        workers.emplace_back(parse, i);
+    }
+    parse(0); // The calling thread takes the first chunk
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    // Report the first malformed line in file order
+    for (const std::exception_ptr& error : errors) {
+        if (error) std::rethrow_exception(error);
+    }
+
+    if (chunkCount == 1) {
+        return std::move(parts[0]);
+    }
+    size_t total = 0;
+    for (const auto& part : parts) total += part.size();
+    std::vector<Activity> activities;
+    activities.reserve(total);
+    for (auto& part : parts) {
+        std::move(part.begin(), part.end(), std::back_inserter(activities));
+    }
+    return activities;
+}
+
+// Reads a whole column with a single bulk read
+template <typename T>
+static void readColumn(std::istream& in, std::vector<T>& column) {
+    const auto bytes = static_cast<std::streamsize>(column.size() * sizeof(T));
+    if (!in.read(reinterpret_cast<char*>(column.data()), bytes)) {
+        throw std::runtime_error("Error: Truncated binary file");
+    }
+}
+
+// Bytes between the read position and the end of the stream (unlimited if the stream cannot seek)
+static uint64_t remainingBytes(std::istream& in) {
+    const std::istream::pos_type position = in.tellg();
+    if (position == std::istream::pos_type(-1) || !in.seekg(0, std::ios::end)) {
+        in.clear();
+        return std::numeric_limits<uint64_t>::max();
+    }
+    const std::istream::pos_type end = in.tellg();
+    in.seekg(position);
+    return end > position ? static_cast<uint64_t>(end - position) : 0;
+}
+
+// Reads the binary format: one bulk read per column, then activities are built in place
+std::vector<Activity> readBinaryActivities(std::istream& in) {
+    BinaryFileHeader header{};
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, BINARY_FORMAT_MAGIC, sizeof(header.magic)) != 0) {
+        throw std::runtime_error("Error: Not a binary TodoList file");
+    }
+    if (header.version < BINARY_FORMAT_MIN_VERSION || header.version > BINARY_FORMAT_VERSION) {
+        throw std::runtime_error("Error: Unsupported binary format version " + std::to_string(header.version));
+    }
+
+    // The columns are sized from the header, so it is checked against the rest of the file before allocating
+    const uint64_t count = header.count;
+    const uint64_t available = remainingBytes(in);
+    const uint64_t bytesPerActivity = (header.version >= 2 ? 3 : 2) * sizeof(uint64_t);
+    if (count > available / bytesPerActivity ||
+        count * bytesPerActivity + ((count + 63) / 64 + 1) * sizeof(uint64_t) > available) {
+        throw std::runtime_error("Error: Truncated binary file");
+    }
+    std::vector<int64_t> dueDates(count);
+    std::vector<uint64_t> ids(count, 0); // Version 1 has no id column: ids stay unassigned
+    std::vector<uint64_t> completedBits((count + 63) / 64);
+    std::vector<uint64_t> offsets(count + 1);
+    readColumn(in, dueDates);
+    if (header.version >= 2) {
+        readColumn(in, ids);
+    }
+    readColumn(in, completedBits);
+    readColumn(in, offsets);
+
+    if (offsets[0] != 0) {
+        throw std::runtime_error("Error: Corrupted description offsets in binary file");
+    }
+    for (uint64_t i = 0; i < count; ++i) {
+        if (offsets[i + 1] < offsets[i]) {
+            throw std::runtime_error("Error: Corrupted description offsets in binary file");
+        }
+    }
+
+    if (offsets[count] > remainingBytes(in)) {
+        throw std::runtime_error("Error: Truncated binary file");
+    }
+    std::vector<char> blob(offsets[count]);
+    readColumn(in, blob);
+
+    std::vector<Activity> activities;
+    activities.reserve(count);
+    for (uint64_t i = 0; i < count; ++i) {
+        const bool completed = (completedBits[i / 64] >> (i % 64)) & 1U;
+        activities.emplace_back(std::string(blob.data() + offsets[i], offsets[i + 1] - offsets[i]),
+                                completed, static_cast<time_t>(dueDates[i]));
+        activities.back().setId(ids[i]);
+    }
+    return activities;
+}
+
+// Writes the whole file through a stream, reporting open and write failures with the OS reason
+static void writeStreamFile(const std::string& filename, const std::vector<Activity>& activities, FileFormat format,
+                            const LiveSlots* live) {
+    std::ofstream file(filename, format == FileFormat::Binary ? std::ios::out | std::ios::binary : std::ios::out);
+    if (!file) { // File opening check
+        throw std::runtime_error("Error opening file for writing: " + filename + " (" + std::strerror(errno) + ")");
+    }
+
+    if (format == FileFormat::Binary) {
+        writeBinaryActivities(file, activities, live);
+    } else {
+        writeTextActivities(file, activities, std::max(1U, std::thread::hardware_concurrency()), live);
+    }
+
+    file.close();
+    if (!file) {
+        throw std::runtime_error("Error writing file: " + filename + " (" + std::strerror(errno) + ")");
+    }
+}
+
+#ifdef TODOLIST_HAS_FSYNC
+// Flushes a file or directory to stable storage
+static void syncPath(const std::string& path, int flags) {
+    int fd = ::open(path.c_str(), flags);
+    if (fd < 0 || ::fsync(fd) != 0) {
+        const int error = errno;
+        if (fd >= 0) ::close(fd);
+        throw std::runtime_error("Error syncing " + path + " (" + std::strerror(error) + ")");
+    }
+    ::close(fd);
+}
+
+// Creates an empty file next to the target under a random suffix and returns its name. open() applies the
+// umask just as it would when creating the target; when the target exists, its mode is copied instead.
+static std::string createTempFile(const std::string& filename) {
+    static thread_local std::mt19937_64 random(std::random_device{}());
+    constexpr int ATTEMPTS = 100;
+    for (int attempt = 0; attempt < ATTEMPTS; ++attempt) {
+        char suffix[17];
+        std::snprintf(suffix, sizeof(suffix), "%016llx", static_cast<unsigned long long>(random()));
+        const std::string tempName = filename + ".tmp." + suffix;
+        const int fd = ::open(tempName.c_str(), O_CREAT | O_EXCL | O_WRONLY | O_CLOEXEC, 0666);
+        if (fd < 0) {
+            if (errno == EEXIST) continue;
+            throw std::runtime_error("Error creating temporary file for: " + filename + " (" + std::strerror(errno) + ")");
+        }
+        struct stat existing {};
+        if (::stat(filename.c_str(), &existing) == 0 && ::fchmod(fd, existing.st_mode & 07777) != 0) {
+            const int error = errno;
+            ::close(fd);
+            ::unlink(tempName.c_str());
+            throw std::runtime_error("Error setting permissions of temporary file for: " + filename + " (" + std::strerror(error) + ")");
+        }
+        ::close(fd);
+        return tempName;
+    }
+    throw std::runtime_error("Error creating temporary file for: " + filename + " (" + std::strerror(EEXIST) + ")");
+}
+#endif
+
+void writeActivitiesFile(const std::string& filename, const std::vector<Activity>& activities, FileFormat format, SaveMode mode,
+                         const LiveSlots* live) {
+    if (mode == SaveMode::InPlace) {
+        writeStreamFile(filename, activities, format, live);
+        return;
+    }
+
+    // The temporary lives next to the target so the rename never crosses file systems
+    const std::filesystem::path target(filename);
+#ifdef TODOLIST_HAS_FSYNC
+    const std::string tempName = createTempFile(filename);
+#else
+    const std::string tempName = filename + ".tmp";
+#endif
+
+    try {
+        writeStreamFile(tempName, activities, format, live);
+#ifdef TODOLIST_HAS_FSYNC
+        syncPath(tempName, O_WRONLY);
+#endif
+        std::filesystem::rename(tempName, target);
+    } catch (const std::exception& e) {
+        std::error_code ignored;
+        std::filesystem::remove(tempName, ignored);
+        throw std::runtime_error(std::string("Error saving file atomically: ") + e.what());
+    }
+
+#ifdef TODOLIST_HAS_FSYNC
+    // Persist the rename itself
+    const std::filesystem::path directory = target.has_parent_path() ? target.parent_path() : std::filesystem::path(".");
+    syncPath(directory.string(), O_RDONLY | O_DIRECTORY);
+#endif
+}
@@ -0,0 +1,67 @@
+#ifndef FILEFORMAT_H
+#define FILEFORMAT_H
+
+#include "Activity.h"
+#include "LiveSlots.h"
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// On-disk formats understood by TodoList::saveToFile / loadFromFile
+enum class FileFormat {
+    Text,   // One serialized activity per line: "description;1;1678902345;42"
+    Binary  // Versioned columnar layout described below
+};
+
+// How a file is replaced when saving
+enum class SaveMode {
+    InPlace, // Truncates and rewrites the target: fastest, but a crash mid-write loses the old content
+    Atomic   // Writes a temporary file, fsyncs it, renames it over the target and fsyncs the directory
+};
+
+// Binary layout (native byte order, every section 8-byte aligned):
+//   char     magic[4]                    "TDLB"
+//   uint32_t version                     BINARY_FORMAT_VERSION
+//   uint64_t count                       number of activities
+//   int64_t  dueDates[count]             due date column
+//   uint64_t ids[count]                  activity id column (version 2 and later)
+//   uint64_t completedBits[(count+63)/64] bit i set when activity i is completed
+//   uint64_t descOffsets[count + 1]      description i is blob[offsets[i], offsets[i+1])
+//   char     descBlob[descOffsets[count]]
+// Offsets (instead of per-record lengths) give O(1) access to any description.
+// Version 1 files (without ids) are still read; their activities get fresh ids when loaded.
+constexpr char BINARY_FORMAT_MAGIC[4] = {'T', 'D', 'L', 'B'};
+constexpr uint32_t BINARY_FORMAT_VERSION = 2;
+constexpr uint32_t BINARY_FORMAT_MIN_VERSION = 1;
+
+struct BinaryFileHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t count;
+};
+
+// Peeks at the first bytes of the stream (without consuming them) to detect the format
+FileFormat detectFileFormat(std::istream& in);
+
+// Writers: the stream must be opened in binary mode for FileFormat::Binary.
+// When live is given, only the activities in its live slots are written (tombstones are skipped).
+// Text is serialized in blocks on up to `threads` threads into reused buffers, then written in order
+void writeTextActivities(std::ostream& out, const std::vector<Activity>& activities, unsigned threads = 1,
+                         const LiveSlots* live = nullptr);
+void writeBinaryActivities(std::ostream& out, const std::vector<Activity>& activities, const LiveSlots* live = nullptr);
+
+// Writes the activities to a file in the given format; throws std::runtime_error on failure
+void writeActivitiesFile(const std::string& filename, const std::vector<Activity>& activities, FileFormat format, SaveMode mode,
+                         const LiveSlots* live = nullptr);
+
+// Readers: throw std::invalid_argument / std::runtime_error on malformed input
+std::vector<Activity> readTextActivities(std::istream& in);
+// Parses a whole text file already in memory, splitting it into newline-aligned chunks
+// parsed on up to `threads` threads; the result keeps file order
+std::vector<Activity> parseTextActivities(std::string_view text, unsigned threads);
+std::vector<Activity> readBinaryActivities(std::istream& in);
+
+#endif
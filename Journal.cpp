@@ -0,0 +1,282 @@
+#include "Journal.h"
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define TODOLIST_HAS_FSYNC 1
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Upper bound on a record's payload, so a garbled length cannot trigger a huge allocation
+constexpr uint32_t MAX_RECORD_SIZE = 64U * 1024U * 1024U;
+
+// FNV-1a over the payload, enough to detect torn or garbled records
+static uint32_t checksum(const char* data, size_t size) {
+    uint32_t hash = 2166136261U;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 16777619U;
+    }
+    return hash;
+}
+
+template <typename T>
+static void put(std::string& buffer, T value) {
+    buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+static void putString(std::string& buffer, const std::string& text) {
+    put<uint32_t>(buffer, static_cast<uint32_t>(text.size()));
+    buffer += text;
+}
+
+// Reads a fixed-size value from the payload, advancing the cursor; false if the payload is too short
+template <typename T>
+static bool get(const std::string& payload, size_t& pos, T& value) {
+    if (payload.size() - pos < sizeof(T)) return false;
+    std::memcpy(&value, payload.data() + pos, sizeof(T));
+    pos += sizeof(T);
+    return true;
+}
+
+static bool getString(const std::string& payload, size_t& pos, std::string& text) {
+    uint32_t size = 0;
+    if (!get(payload, pos, size) || payload.size() - pos < size) return false;
+    text.assign(payload, pos, size);
+    pos += size;
+    return true;
+}
+
+// fsync() applies to the file, not the descriptor, so a second descriptor covers what the stream wrote
+Journal::Journal(std::string journalPath, JournalSync sync) : path(std::move(journalPath)), syncMode(sync) {
+    out.open(path, std::ios::out | std::ios::app | std::ios::binary);
+    if (!out) {
+        throw std::runtime_error("Error opening journal: " + path);
+    }
+#ifdef TODOLIST_HAS_FSYNC
+    if (syncMode != JournalSync::Process) {
+        syncFd = ::open(path.c_str(), O_WRONLY | O_CLOEXEC);
+        if (syncFd < 0) {
+            throw std::runtime_error("Error opening journal: " + path + " (" + std::strerror(errno) + ")");
+        }
+    }
+#endif
+}
+
+Journal::~Journal() {
+#ifdef TODOLIST_HAS_FSYNC
+    if (syncFd >= 0) ::close(syncFd);
+#endif
+}
+
+void Journal::syncToDisk() {
+#ifdef TODOLIST_HAS_FSYNC
+    if (::fsync(syncFd) != 0) {
+        throw std::runtime_error("Error syncing journal: " + path + " (" + std::strerror(errno) + ")");
+    }
+#endif
+    ++syncCount;
+}
+
+void Journal::sync() {
+    if (syncMode == JournalSync::Mutation && unsynced) {
+        syncToDisk();
+        unsynced = false;
+    }
+}
+
+// Frames and appends one record, flushing it to the OS; Record mode also syncs it to stable storage
+void Journal::append(const std::string& payload) {
+    std::string record;
+    record.reserve(payload.size() + 2 * sizeof(uint32_t));
+    put<uint32_t>(record, static_cast<uint32_t>(payload.size()));
+    record += payload;
+    put<uint32_t>(record, checksum(payload.data(), payload.size()));
+
+    out.write(record.data(), static_cast<std::streamsize>(record.size()));
+    out.flush();
+    if (!out) {
+        throw std::runtime_error("Error writing journal: " + path);
+    }
+    ++recordCount;
+    if (syncMode == JournalSync::Record) {
+        syncToDisk();
+    } else if (syncMode == JournalSync::Mutation) {
+        unsynced = true;
+    }
+}
+
+void Journal::appendAdd(const Activity& activity) {
+    std::string payload;
+    put(payload, JournalOp::Add);
+    put<uint8_t>(payload, activity.isCompleted() ? 1 : 0);
+    put<int64_t>(payload, activity.getDueDate());
+    put<uint64_t>(payload, activity.getId());
+    putString(payload, activity.getDescription());
+    append(payload);
+}
+
+void Journal::appendRemove(uint64_t index) {
+    std::string payload;
+    put(payload, JournalOp::Remove);
+    put(payload, index);
+    append(payload);
+}
+
+void Journal::appendSetCompleted(uint64_t index, bool completed) {
+    std::string payload;
+    put(payload, JournalOp::SetCompleted);
+    put(payload, index);
+    put<uint8_t>(payload, completed ? 1 : 0);
+    append(payload);
+}
+
+void Journal::appendEdit(uint64_t index, uint8_t flags, const std::string& description, bool completed, time_t dueDate) {
+    std::string payload;
+    put(payload, JournalOp::Edit);
+    put(payload, index);
+    put(payload, flags);
+    put<uint8_t>(payload, completed ? 1 : 0);
+    put<int64_t>(payload, dueDate);
+    putString(payload, (flags & JOURNAL_EDIT_DESCRIPTION) ? description : std::string());
+    append(payload);
+}
+
+void Journal::appendSetName(const std::string& name) {
+    std::string payload;
+    put(payload, JournalOp::SetName);
+    putString(payload, name);
+    append(payload);
+}
+
+// Reopens the file truncated, discarding every record; the header does not count towards the checkpoint interval
+void Journal::reset(uint64_t snapshotFingerprint) {
+    out.close();
+    out.open(path, std::ios::out | std::ios::trunc | std::ios::binary);
+    if (!out) {
+        throw std::runtime_error("Error opening journal: " + path);
+    }
+    std::string payload;
+    put(payload, JournalOp::Checkpoint);
+    put(payload, snapshotFingerprint);
+    append(payload);
+    recordCount = 0;
+}
+
+const std::string& Journal::getPath() const {
+    return path;
+}
+
+JournalSync Journal::getSyncMode() const {
+    return syncMode;
+}
+
+size_t Journal::getRecordCount() const {
+    return recordCount;
+}
+
+size_t Journal::getSyncCount() const {
+    return syncCount;
+}
+
+// Decodes records until the end of the file or the first torn/corrupted record
+std::vector<JournalRecord> Journal::read(const std::string& journalPath) {
+    std::vector<JournalRecord> records;
+    std::ifstream in(journalPath, std::ios::in | std::ios::binary);
+    if (!in) {
+        return records;
+    }
+
+    uint32_t size = 0;
+    while (in.read(reinterpret_cast<char*>(&size), sizeof(size)) && size <= MAX_RECORD_SIZE) {
+        std::string payload(size, '\0');
+        uint32_t storedChecksum = 0;
+        if (!in.read(payload.data(), size) ||
+            !in.read(reinterpret_cast<char*>(&storedChecksum), sizeof(storedChecksum)) ||
+            storedChecksum != checksum(payload.data(), payload.size())) {
+            break; // Torn tail left by a crash: keep what was fully written
+        }
+
+        JournalRecord record;
+        size_t pos = 0;
+        uint8_t flag = 0;
+        bool ok = get(payload, pos, record.op);
+        if (ok) {
+            switch (record.op) {
+                case JournalOp::Add:
+                    ok = get(payload, pos, flag) && get(payload, pos, record.dueDate) &&
+                         get(payload, pos, record.id) && getString(payload, pos, record.text);
+                    break;
+                case JournalOp::Remove:
+                    ok = get(payload, pos, record.index);
+                    break;
+                case JournalOp::SetCompleted:
+                    ok = get(payload, pos, record.index) && get(payload, pos, flag);
+                    break;
+                case JournalOp::Edit:
+                    ok = get(payload, pos, record.index) && get(payload, pos, record.editFlags) &&
+                         get(payload, pos, flag) && get(payload, pos, record.dueDate) &&
+                         getString(payload, pos, record.text);
+                    break;
+                case JournalOp::SetName:
+                    ok = getString(payload, pos, record.text);
+                    break;
+                case JournalOp::Checkpoint:
+                    ok = get(payload, pos, record.snapshotFingerprint);
+                    break;
+                default:
+                    ok = false;
+            }
+        }
+        if (!ok) {
+            throw std::runtime_error("Error: Corrupted record in journal " + journalPath);
+        }
+        record.completed = flag != 0;
+        records.push_back(std::move(record));
+    }
+    return records;
+}
+
+// A journal that does not start with a Checkpoint cannot be tied to any snapshot, so it is never replayed
+std::vector<JournalRecord> Journal::readFor(const std::string& snapshotFile) {
+    std::vector<JournalRecord> records = read(pathFor(snapshotFile));
+    if (records.empty() || records.front().op != JournalOp::Checkpoint ||
+        records.front().snapshotFingerprint != fingerprint(snapshotFile)) {
+        return {};
+    }
+    records.erase(records.begin());
+    return records;
+}
+
+// FNV-1a over 8-byte words (the tail is zero-padded), then the size: a fast hash with no collisions in practice
+uint64_t Journal::fingerprint(const std::string& snapshotFile) {
+    std::ifstream in(snapshotFile, std::ios::in | std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Error opening file: " + snapshotFile);
+    }
+    uint64_t hash = 14695981039346656037ULL;
+    uint64_t size = 0;
+    std::vector<uint64_t> block(8192);
+    while (in) {
+        in.read(reinterpret_cast<char*>(block.data()), static_cast<std::streamsize>(block.size() * sizeof(uint64_t)));
+        const auto bytes = static_cast<size_t>(in.gcount());
+        if (bytes % sizeof(uint64_t) != 0) {
+            std::memset(reinterpret_cast<char*>(block.data()) + bytes, 0, sizeof(uint64_t) - bytes % sizeof(uint64_t));
+        }
+        for (size_t i = 0; i < (bytes + sizeof(uint64_t) - 1) / sizeof(uint64_t); ++i) {
+            hash = (hash ^ block[i]) * 1099511628211ULL;
+        }
+        size += bytes;
+    }
+    if (in.bad()) {
+        throw std::runtime_error("Error reading file: " + snapshotFile);
+    }
+    return (hash ^ size) * 1099511628211ULL;
+}
+
+std::string Journal::pathFor(const std::string& snapshotFile) {
+    return snapshotFile + ".journal";
+}
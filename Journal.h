@@ -0,0 +1,120 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include "Activity.h"
+#include "FileFormat.h"
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Kinds of mutations recorded in a TodoList journal
+enum class JournalOp : uint8_t {
+    Add = 1,          // Appends an activity (with its id)
+    Remove = 2,       // Removes the activity at a 0-based position
+    SetCompleted = 3, // Changes the completion status at a position
+    Edit = 4,         // Changes any subset of the fields at a position
+    SetName = 5,      // Renames the list
+    Checkpoint = 6    // First record: fingerprint of the snapshot the other records apply to
+};
+
+// How durable a journal record is once the mutation that wrote it returns
+enum class JournalSync : uint8_t {
+    Process,  // Written to the OS: survives a crash of the process, not of the machine (a power loss)
+    Record,   // Synced to stable storage after every record
+    Mutation  // Synced once per TodoList mutation, so a bulk change or a Batch costs a single fsync
+};
+
+// Flags telling which fields an Edit record changes
+constexpr uint8_t JOURNAL_EDIT_DESCRIPTION = 1;
+constexpr uint8_t JOURNAL_EDIT_COMPLETED = 2;
+constexpr uint8_t JOURNAL_EDIT_DUE_DATE = 4;
+
+// One decoded journal record; unused fields keep their defaults
+struct JournalRecord {
+    JournalOp op = JournalOp::Add;
+    uint64_t index = 0;
+    uint8_t editFlags = 0;
+    bool completed = false;
+    int64_t dueDate = 0;
+    uint64_t id = 0; // Id of the added activity
+    std::string text; // Description for Add/Edit, new name for SetName
+    uint64_t snapshotFingerprint = 0; // Checkpoint only
+};
+
+// Append-only log of TodoList mutations.
+// Each record is framed as [uint32 length][payload][uint32 checksum], so a record torn by a crash
+// is detected and everything before it is still replayed. Which crashes a record survives depends on
+// the JournalSync mode: by default only a crash of the process.
+// A journal starts with a Checkpoint record holding the fingerprint of the snapshot file it follows, so it is
+// never replayed onto another version of that file (a newer checkpoint whose journal was not truncated yet
+// because of a crash, or a plain save over the snapshot).
+class Journal {
+private:
+    std::string path;
+    std::ofstream out;
+    JournalSync syncMode;
+    int syncFd = -1;        // Descriptor fsync() is called on, unless the mode is Process
+    bool unsynced = false;  // Records appended since the last sync (Mutation mode)
+    size_t recordCount = 0; // Records appended since the last reset()
+    size_t syncCount = 0;
+
+    void append(const std::string& payload);
+    void syncToDisk();
+
+public:
+    // Opens (or creates) the journal file for appending; throws std::runtime_error on failure
+    explicit Journal(std::string journalPath, JournalSync sync = JournalSync::Process);
+    ~Journal();
+
+    Journal(const Journal&) = delete;
+    Journal& operator=(const Journal&) = delete;
+
+    void appendAdd(const Activity& activity);
+    void appendRemove(uint64_t index);
+    void appendSetCompleted(uint64_t index, bool completed);
+    void appendEdit(uint64_t index, uint8_t flags, const std::string& description, bool completed, time_t dueDate);
+    void appendSetName(const std::string& name);
+
+    // Truncates the journal right after a checkpoint and starts it with the new snapshot's fingerprint
+    void reset(uint64_t snapshotFingerprint);
+    // In Mutation mode, syncs the records appended since the last call; throws std::runtime_error on failure,
+    // keeping them pending for the next call
+    void sync();
+
+    [[nodiscard]] const std::string& getPath() const;
+    [[nodiscard]] JournalSync getSyncMode() const;
+    [[nodiscard]] size_t getRecordCount() const;
+    // Number of fsync() calls made so far
+    [[nodiscard]] size_t getSyncCount() const;
+
+    // Reads every intact record of a journal file, Checkpoint included (a missing file yields no records)
+    static std::vector<JournalRecord> read(const std::string& journalPath);
+    // Reads the records to replay on top of a snapshot file: none if its journal does not start with the
+    // Checkpoint of this version of the file
+    static std::vector<JournalRecord> readFor(const std::string& snapshotFile);
+    // Hash of a file's contents and size; throws std::runtime_error if it cannot be read
+    static uint64_t fingerprint(const std::string& snapshotFile);
+    // Returns the journal path used for a given snapshot file
+    static std::string pathFor(const std::string& snapshotFile);
+};
+
+// Holds a TodoList's journal and checkpoint settings; copies of a TodoList start detached instead of sharing the log
+struct JournalSlot {
+    std::unique_ptr<Journal> journal;
+    std::string snapshotFile;
+    FileFormat snapshotFormat = FileFormat::Binary;
+    size_t checkpointInterval = 0;
+
+    JournalSlot() = default;
+    JournalSlot(const JournalSlot&) {}
+    JournalSlot& operator=(const JournalSlot& other) {
+        if (this != &other) *this = JournalSlot();
+        return *this;
+    }
+    JournalSlot(JournalSlot&&) noexcept = default;
+    JournalSlot& operator=(JournalSlot&&) noexcept = default;
+};
+
+#endif
@@ -0,0 +1,71 @@
+#include "LiveSlots.h"
+
+void LiveSlots::clear() {
+    liveBits.clear();
+    tree.assign(1, 0);
+    slots = 0;
+    live = 0;
+}
+
+void LiveSlots::reserve(size_t n) {
+    liveBits.reserve((n + 63) / 64);
+    tree.reserve(n + 1);
+}
+
+// With every slot live, node i covers exactly lowbit(i) slots
+void LiveSlots::assign(size_t count) {
+    liveBits.assign((count + 63) / 64, ~uint64_t{0});
+    if (count % 64 != 0) {
+        liveBits.back() = (uint64_t{1} << (count % 64)) - 1;
+    }
+    tree.resize(count + 1);
+    for (size_t i = 1; i <= count; ++i) {
+        tree[i] = i & (~i + 1);
+    }
+    slots = count;
+    live = count;
+}
+
+// Node i covers slots (i - lowbit(i), i]: the new slot plus the live slots already in that range
+void LiveSlots::pushBack() {
+    if (slots % 64 == 0) {
+        liveBits.push_back(0);
+    }
+    liveBits[slots / 64] |= uint64_t{1} << (slots % 64);
+    ++slots;
+    ++live;
+    const size_t lowBit = slots & (~slots + 1);
+    tree.push_back(1 + prefix(slots - 1) - prefix(slots - lowBit));
+}
+
+void LiveSlots::kill(size_t slot) {
+    liveBits[slot / 64] &= ~(uint64_t{1} << (slot % 64));
+    --live;
+    for (size_t i = slot + 1; i <= slots; i += i & (~i + 1)) {
+        --tree[i];
+    }
+}
+
+size_t LiveSlots::prefix(size_t count) const {
+    size_t sum = 0;
+    for (size_t i = count; i > 0; i -= i & (~i + 1)) {
+        sum += tree[i];
+    }
+    return sum;
+}
+
+// Descends the tree from the largest power of two, skipping whole ranges with too few live slots
+size_t LiveSlots::select(size_t position) const {
+    size_t step = 1;
+    while (step * 2 <= slots) step *= 2;
+
+    size_t slot = 0;
+    size_t remaining = position;
+    for (; step > 0; step /= 2) {
+        if (slot + step <= slots && tree[slot + step] <= remaining) {
+            slot += step;
+            remaining -= tree[slot];
+        }
+    }
+    return slot;
+}
@@ -0,0 +1,44 @@
+#ifndef LIVESLOTS_H
+#define LIVESLOTS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Tracks which slots of a storage vector still hold a live element after removals left tombstones.
+// A Fenwick tree over the live flags converts between slot numbers and positions among the
+// live slots (list positions) in O(log n), so removing never has to shift anything.
+class LiveSlots {
+private:
+    std::vector<uint64_t> liveBits; // Bit i is set while slot i is live
+    std::vector<size_t> tree;       // 1-based Fenwick tree of live counts; tree[0] is unused
+    size_t slots = 0;
+    size_t live = 0;
+
+    // Number of live slots among the first count slots
+    [[nodiscard]] size_t prefix(size_t count) const;
+
+public:
+    LiveSlots() : tree(1, 0) {}
+
+    void clear();
+    void reserve(size_t n);
+    // Resets to count slots, all live
+    void assign(size_t count);
+    // Appends a live slot
+    void pushBack();
+    // Turns a live slot into a tombstone
+    void kill(size_t slot);
+
+    [[nodiscard]] bool isLive(size_t slot) const { return (liveBits[slot / 64] >> (slot % 64)) & 1U; }
+    [[nodiscard]] size_t slotCount() const { return slots; }
+    [[nodiscard]] size_t liveCount() const { return live; }
+    [[nodiscard]] size_t deadCount() const { return slots - live; }
+
+    // Returns the 0-based list position of a live slot (the number of live slots before it)
+    [[nodiscard]] size_t rank(size_t slot) const { return prefix(slot); }
+    // Returns the slot holding the live element at a 0-based list position (position < liveCount())
+    [[nodiscard]] size_t select(size_t position) const;
+};
+
+#endif
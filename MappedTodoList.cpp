@@ -0,0 +1,182 @@
+#include "MappedTodoList.h"
+#include "FileFormat.h"
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define TODOLIST_HAS_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Maps the file (or reads it into an aligned buffer) and locates the columns without parsing them
+MappedTodoList::MappedTodoList(const std::string& filename) {
+#ifdef TODOLIST_HAS_MMAP
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Error opening file: " + filename);
+    }
+    struct stat st{};
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Error opening file: " + filename);
+    }
+    length = static_cast<size_t>(st.st_size);
+    if (length >= sizeof(BinaryFileHeader)) {
+        void* mapping = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("Error mapping file: " + filename);
+        }
+        data = static_cast<const char*>(mapping);
+    }
+    ::close(fd); // The mapping stays valid after the descriptor is closed
+#else
+    std::ifstream file(filename, std::ios::in | std::ios::binary | std::ios::ate);
+    if (!file) {
+        throw std::runtime_error("Error opening file: " + filename);
+    }
+    length = static_cast<size_t>(file.tellg());
+    file.seekg(0);
+    fallbackBuffer.resize((length + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+    file.read(reinterpret_cast<char*>(fallbackBuffer.data()), static_cast<std::streamsize>(length));
+    data = reinterpret_cast<const char*>(fallbackBuffer.data());
+#endif
+
+    if (data == nullptr || length < sizeof(BinaryFileHeader)) {
+        unmap();
+        throw std::runtime_error("Error: Not a binary TodoList file: " + filename);
+    }
+
+    BinaryFileHeader header{};
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, BINARY_FORMAT_MAGIC, sizeof(header.magic)) != 0) {
+        unmap();
+        throw std::runtime_error("Error: Not a binary TodoList file: " + filename);
+    }
+    if (header.version < BINARY_FORMAT_MIN_VERSION || header.version > BINARY_FORMAT_VERSION) {
+        unmap();
+        throw std::runtime_error("Error: Unsupported binary format version " + std::to_string(header.version));
+    }
+
+    // Column sizes are checked against the file size before any pointer is handed out
+    count = header.count;
+    const uint64_t maxCount = length / sizeof(int64_t);
+    const uint64_t bitWords = (count + 63) / 64;
+    const uint64_t idWords = header.version >= 2 ? count : 0;
+    const uint64_t columnsEnd = count > maxCount ? length + 1
+        : sizeof(BinaryFileHeader) + (count + idWords + bitWords + count + 1) * sizeof(uint64_t);
+    if (columnsEnd > length) {
+        unmap();
+        throw std::runtime_error("Error: Truncated binary file: " + filename);
+    }
+
+    dueDates = reinterpret_cast<const int64_t*>(data + sizeof(BinaryFileHeader));
+    ids = idWords > 0 ? reinterpret_cast<const uint64_t*>(dueDates + count) : nullptr;
+    completedBits = reinterpret_cast<const uint64_t*>(dueDates + count) + idWords;
+    descOffsets = completedBits + bitWords;
+    descBlob = data + columnsEnd;
+
+    if (descOffsets[0] != 0 || descOffsets[count] > length - columnsEnd) {
+        unmap();
+        throw std::runtime_error("Error: Truncated binary file: " + filename);
+    }
+}
+
+MappedTodoList::~MappedTodoList() {
+    unmap();
+}
+
+MappedTodoList::MappedTodoList(MappedTodoList&& other) noexcept {
+    *this = std::move(other);
+}
+
+MappedTodoList& MappedTodoList::operator=(MappedTodoList&& other) noexcept {
+    if (this != &other) {
+        unmap();
+        data = std::exchange(other.data, nullptr);
+        length = std::exchange(other.length, 0);
+        fallbackBuffer = std::move(other.fallbackBuffer);
+        count = std::exchange(other.count, 0);
+        dueDates = std::exchange(other.dueDates, nullptr);
+        ids = std::exchange(other.ids, nullptr);
+        completedBits = std::exchange(other.completedBits, nullptr);
+        descOffsets = std::exchange(other.descOffsets, nullptr);
+        descBlob = std::exchange(other.descBlob, nullptr);
+        editedActivities = std::move(other.editedActivities);
+    }
+    return *this;
+}
+
+// Releases the mapping (or the fallback buffer)
+void MappedTodoList::unmap() {
+#ifdef TODOLIST_HAS_MMAP
+    if (data != nullptr) {
+        ::munmap(const_cast<char*>(data), length);
+    }
+#endif
+    fallbackBuffer.clear();
+    data = nullptr;
+    length = 0;
+    count = 0;
+}
+
+size_t MappedTodoList::size() const {
+    return count;
+}
+
+// Edited activities are served from their copy, all others straight from the mapping
+ActivityView MappedTodoList::at(size_t index) const {
+    if (index >= count) {
+        throw std::out_of_range("Activity index is out of range!");
+    }
+
+    auto edited = editedActivities.find(index);
+    if (edited != editedActivities.end()) {
+        const Activity& activity = edited->second;
+        return {activity.getDescription(), activity.isCompleted(), activity.getDueDate(), activity.getId()};
+    }
+
+    const uint64_t begin = descOffsets[index];
+    const uint64_t end = descOffsets[index + 1];
+    if (end < begin || end > descOffsets[count]) {
+        throw std::runtime_error("Error: Corrupted description offsets in binary file");
+    }
+    const bool completed = (completedBits[index / 64] >> (index % 64)) & 1U;
+    return {std::string_view(descBlob + begin, end - begin), completed, static_cast<time_t>(dueDates[index]),
+            ids != nullptr ? ids[index] : ActivityId{0}};
+}
+
+// Copy-on-write: the first edit of an activity copies it out of the read-only mapping
+Activity& MappedTodoList::edit(size_t index) {
+    auto edited = editedActivities.find(index);
+    if (edited != editedActivities.end()) {
+        return edited->second;
+    }
+
+    ActivityView view = at(index);
+    auto inserted = editedActivities.emplace(index, Activity(std::string(view.description), view.completed, view.dueDate));
+    inserted.first->second.setId(view.id);
+    return inserted.first->second;
+}
+
+size_t MappedTodoList::getEditedActivities() const {
+    return editedActivities.size();
+}
+
+TodoList MappedTodoList::toTodoList(const std::string& listName) const {
+    std::vector<Activity> activities;
+    activities.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        ActivityView view = at(i);
+        activities.emplace_back(std::string(view.description), view.completed, view.dueDate);
+        activities.back().setId(view.id); // Kept unless it is 0 or already taken
+    }
+    TodoList list(listName);
+    list.addActivities(std::move(activities));
+    return list;
+}
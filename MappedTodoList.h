@@ -0,0 +1,64 @@
+#ifndef MAPPEDTODOLIST_H
+#define MAPPEDTODOLIST_H
+
+#include "Activity.h"
+#include "TodoList.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Read-only view of an activity; the description points into the mapped file (or into an edited copy)
+struct ActivityView {
+    std::string_view description;
+    bool completed;
+    time_t dueDate;
+    ActivityId id;
+};
+
+// Opens a binary TodoList file by memory-mapping it: nothing is parsed or copied up front,
+// activities are read in place and only the ones that get edited are materialized.
+class MappedTodoList {
+private:
+    const char* data = nullptr; // Start of the mapped file
+    size_t length = 0;          // Size of the mapped file in bytes
+    std::vector<uint64_t> fallbackBuffer; // Holds the file when mmap is not available
+
+    uint64_t count = 0;
+    const int64_t* dueDates = nullptr;
+    const uint64_t* ids = nullptr; // Null for version 1 files, which have no id column
+    const uint64_t* completedBits = nullptr;
+    const uint64_t* descOffsets = nullptr;
+    const char* descBlob = nullptr;
+
+    std::unordered_map<size_t, Activity> editedActivities; // Lazily materialized copies
+
+    void unmap();
+
+public:
+    // Maps the file; throws std::runtime_error if it cannot be opened or is not a valid binary file
+    explicit MappedTodoList(const std::string& filename);
+    ~MappedTodoList();
+
+    MappedTodoList(const MappedTodoList&) = delete;
+    MappedTodoList& operator=(const MappedTodoList&) = delete;
+    MappedTodoList(MappedTodoList&& other) noexcept;
+    MappedTodoList& operator=(MappedTodoList&& other) noexcept;
+
+    // Returns the number of activities in the file
+    [[nodiscard]] size_t size() const;
+
+    // Returns a view of the activity at the given 0-based position (throws std::out_of_range)
+    [[nodiscard]] ActivityView at(size_t index) const;
+
+    // Copies the activity out of the mapping on first use and returns it for modification
+    Activity& edit(size_t index);
+    // Returns the number of activities that have been materialized by edit()
+    [[nodiscard]] size_t getEditedActivities() const;
+
+    // Materializes every activity (including edits) into a regular TodoList
+    [[nodiscard]] TodoList toTodoList(const std::string& listName) const;
+};
+
+#endif
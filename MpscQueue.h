@@ -0,0 +1,83 @@
+#ifndef MPSCQUEUE_H
+#define MPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+// Bounded lock-free queue for many producers and a single consumer.
+// Each cell carries a sequence number (Vyukov's bounded queue): producers claim a position with one
+// compare-and-swap on the tail and publish the value by bumping the cell's sequence, so neither side
+// ever takes a lock. Values come out in the order their positions were claimed.
+template <typename T>
+class MpscQueue {
+private:
+    struct Cell {
+        std::atomic<size_t> sequence{0};
+        T value;
+    };
+
+    std::unique_ptr<Cell[]> cells;
+    size_t mask = 0;
+    alignas(64) std::atomic<size_t> tail{0}; // Next position claimed by a producer
+    alignas(64) std::atomic<size_t> head{0}; // Next position read by the consumer (only the consumer writes it)
+
+public:
+    // The capacity is rounded up to a power of two
+    explicit MpscQueue(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) size *= 2;
+        cells = std::make_unique<Cell[]>(size);
+        mask = size - 1;
+        for (size_t i = 0; i < size; ++i) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    // Returns false (leaving value untouched) when the queue is full
+    bool tryPush(T& value) {
+        size_t position = tail.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells[position & mask];
+            const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const auto difference = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position);
+            if (difference == 0) {
+                if (tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+            } else if (difference < 0) {
+                return false;
+            } else {
+                position = tail.load(std::memory_order_relaxed);
+            }
+        }
+        cell->value = std::move(value);
+        cell->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer only; returns false when the next value is not published yet
+    bool tryPop(T& value) {
+        const size_t position = head.load(std::memory_order_relaxed);
+        Cell& cell = cells[position & mask];
+        if (cell.sequence.load(std::memory_order_acquire) != position + 1) {
+            return false;
+        }
+        value = std::move(cell.value);
+        cell.sequence.store(position + mask + 1, std::memory_order_release);
+        head.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Number of positions ever claimed by producers (values pushed or being pushed)
+    [[nodiscard]] size_t pushedCount() const { return tail.load(std::memory_order_acquire); }
+    // Number of values ever taken by the consumer
+    [[nodiscard]] size_t poppedCount() const { return head.load(std::memory_order_acquire); }
+    [[nodiscard]] size_t capacity() const { return mask + 1; }
+};
+
+#endif
@@ -1,9 +1,39 @@
 #ifndef OBSERVER_H
 #define OBSERVER_H
 
+#include "Activity.h"
+#include <cstddef>
+#include <optional>
+#include <string>
+
+// Kinds of changes a TodoList reports to its observers
+enum class ChangeType {
+    Added,     // newValue was appended at index
+    Removed,   // oldValue was removed from index
+    Edited,    // The activity at index changed from oldValue to newValue
+    Completed, // The activity at index was marked as completed (oldValue/newValue set)
+    Renamed,   // The list was renamed from oldName to newName
+    Reloaded   // Too much changed to describe (file load, batch): observers should re-read everything
+};
+
+// Describes a single change so observers can update incrementally
+struct ChangeEvent {
+    ChangeType type = ChangeType::Reloaded;
+    size_t index = 0; // 0-based position of the affected activity
+    std::optional<Activity> oldValue;
+    std::optional<Activity> newValue;
+    std::string oldName;
+    std::string newName;
+};
+
 class Observer {
 public:
     virtual void update() = 0; // This method will be called when TodoList changes
+    // Called with a description of the change; observers that do not override it fall back to update()
+    virtual void onChange(const ChangeEvent& event) {
+        (void)event;
+        update();
+    }
     virtual ~Observer() = default; // Virtual destructor for safety
 };
 
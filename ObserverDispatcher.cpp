@@ -0,0 +1,114 @@
+#include "ObserverDispatcher.h"
+#include <chrono>
+#include <utility>
+
+ObserverDispatcher::ObserverDispatcher(size_t capacity) : queue(capacity), worker([this] { run(); }) {}
+
+ObserverDispatcher::~ObserverDispatcher() {
+    stopping.store(true);
+    wakeWorker();
+    worker.join();
+}
+
+void ObserverDispatcher::ErrorSlot::record(std::exception_ptr error) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!first) {
+        first = std::move(error);
+    }
+}
+
+std::exception_ptr ObserverDispatcher::ErrorSlot::take() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return std::exchange(first, nullptr);
+}
+
+void ObserverDispatcher::post(Observer* observer, std::shared_ptr<const ChangeEvent> event, std::shared_ptr<ErrorSlot> errors) {
+    Notification notification{observer, std::move(event), std::move(errors)};
+    while (!queue.tryPush(notification)) {
+        // Full: an observer posting from its callback must make room itself, anyone else waits for the thread
+        if (isDispatcherThread()) {
+            deliverOne();
+        } else {
+            wakeWorker();
+            std::this_thread::yield();
+        }
+    }
+    // Pairs with the fence in run(): either the thread sees the notification or we see it idle
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (idle.load(std::memory_order_relaxed)) {
+        wakeWorker();
+    }
+}
+
+void ObserverDispatcher::flush() {
+    if (isDispatcherThread()) return;
+
+    const size_t target = queue.pushedCount();
+    ++flushWaiters;
+    std::unique_lock<std::mutex> lock(wakeMutex);
+    while (delivered.load() < target) {
+        wake.notify_one();
+        progress.wait_for(lock, std::chrono::milliseconds(1));
+    }
+    --flushWaiters;
+}
+
+bool ObserverDispatcher::isDispatcherThread() const {
+    return std::this_thread::get_id() == worker.get_id();
+}
+
+size_t ObserverDispatcher::getDeliveredCount() const {
+    return delivered.load();
+}
+
+void ObserverDispatcher::wakeWorker() {
+    std::lock_guard<std::mutex> lock(wakeMutex);
+    idle.store(false, std::memory_order_relaxed);
+    wake.notify_one();
+}
+
+bool ObserverDispatcher::deliverOne() {
+    Notification notification;
+    if (!queue.tryPop(notification)) {
+        return false;
+    }
+    try {
+        if (notification.event) {
+            notification.observer->onChange(*notification.event);
+        } else {
+            notification.observer->update();
+        }
+    } catch (...) {
+        // Escaping the thread would terminate the process: kept for the source to rethrow instead
+        if (notification.errors) {
+            notification.errors->record(std::current_exception());
+        }
+    }
+    delivered.fetch_add(1); // Counted either way, or flush() would wait forever
+    if (flushWaiters.load() > 0) {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        progress.notify_all();
+    }
+    return true;
+}
+
+// Delivers until stopped; sleeps on the condition variable only after finding the queue empty
+void ObserverDispatcher::run() {
+    for (;;) {
+        if (deliverOne()) continue;
+        if (queue.poppedCount() != queue.pushedCount()) {
+            std::this_thread::yield(); // A producer claimed a cell but has not filled it yet
+            continue;
+        }
+        if (stopping.load()) return;
+
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        idle.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (queue.poppedCount() == queue.pushedCount() && !stopping.load()) {
+            // The timeout is only a safety net: producers wake the thread when they see it idle
+            wake.wait_for(lock, std::chrono::milliseconds(100));
+        }
+        idle.store(false, std::memory_order_relaxed);
+    }
+}
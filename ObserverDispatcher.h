@@ -0,0 +1,80 @@
+#ifndef OBSERVERDISPATCHER_H
+#define OBSERVERDISPATCHER_H
+
+#include "Observer.h"
+#include "MpscQueue.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+// Delivers observer notifications on a background thread, so a slow observer no longer adds its
+// latency to the mutation that triggered it (see TodoList::setDispatcher()).
+// Any number of lists and threads may post; a single dispatcher thread delivers the notifications
+// in the order they were posted, so each observer sees the changes of a list in order.
+class ObserverDispatcher {
+public:
+    // Where the exceptions thrown by the observers of one source (a list) are kept until it collects them,
+    // so a failing observer is only reported to the list it was notified for
+    class ErrorSlot {
+    private:
+        std::mutex mutex;
+        std::exception_ptr first; // First exception since the last take()
+
+    public:
+        void record(std::exception_ptr error);
+        // Returns the stored exception (or null) and clears it
+        [[nodiscard]] std::exception_ptr take();
+    };
+
+private:
+    // onChange(*event) for the observer, or update() when event is null
+    struct Notification {
+        Observer* observer = nullptr;
+        std::shared_ptr<const ChangeEvent> event;
+        std::shared_ptr<ErrorSlot> errors; // Null: exceptions are dropped
+    };
+
+    MpscQueue<Notification> queue;
+    std::atomic<size_t> delivered{0}; // Notifications whose callback has returned
+    std::atomic<bool> stopping{false};
+    std::atomic<bool> idle{false};    // The dispatcher thread is (about to be) waiting for work
+    std::atomic<size_t> flushWaiters{0};
+    std::mutex wakeMutex;
+    std::condition_variable wake;     // Signals new work to the dispatcher thread
+    std::condition_variable progress; // Signals deliveries to flush()
+    std::thread worker;
+
+    void run();
+    // Pops and delivers one notification; returns false if none was ready
+    bool deliverOne();
+    void wakeWorker();
+
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 4096;
+
+    explicit ObserverDispatcher(size_t capacity = DEFAULT_CAPACITY);
+    // Delivers whatever is still queued, then stops the thread
+    ~ObserverDispatcher();
+
+    ObserverDispatcher(const ObserverDispatcher&) = delete;
+    ObserverDispatcher& operator=(const ObserverDispatcher&) = delete;
+
+    // Queues a notification. When the queue is full the caller waits for room (on the dispatcher
+    // thread itself, the oldest notification is delivered inline instead). An exception thrown by the
+    // observer goes to the error slot; the other notifications are still delivered.
+    void post(Observer* observer, std::shared_ptr<const ChangeEvent> event, std::shared_ptr<ErrorSlot> errors);
+
+    // Waits until every notification posted before the call has been delivered; never throws.
+    // Returns at once when called from an observer, i.e. on the dispatcher thread.
+    void flush();
+
+    [[nodiscard]] bool isDispatcherThread() const;
+    [[nodiscard]] size_t getDeliveredCount() const;
+};
+
+#endif
@@ -15,6 +15,9 @@ public:
 
     // Notifies all registered observers
     virtual void notifyObservers() const = 0;
+
+    // Notifies all registered observers with a description of the change
+    virtual void notifyObservers(const ChangeEvent& event) const = 0;
 };
 
 #endif
\ No newline at end of file
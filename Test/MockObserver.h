@@ -2,13 +2,31 @@
 #define MOCK_OBSERVER_H
 
 #include "../Observer.h"
+#include <vector>
 
 class MockObserver : public Observer {
 public:
     bool updated = false; // Flag to check if update() was called
+    int updateCount = 0;  // Number of times update() was called
 
     void update() override {
         updated = true; // Mark that update() was triggered
+        ++updateCount;
+    }
+};
+
+// Records the change events it receives (legacy update() calls are counted separately)
+class MockChangeObserver : public Observer {
+public:
+    std::vector<ChangeEvent> events;
+    int updateCount = 0;
+
+    void update() override {
+        ++updateCount;
+    }
+
+    void onChange(const ChangeEvent& event) override {
+        events.push_back(event);
     }
 };
 
@@ -1,8 +1,26 @@
 #include "gtest/gtest.h"
 #include "../TodoList.h"
 #include "../Activity.h"
+#include "../MappedTodoList.h"
 #include "MockObserver.h"
+#include "../ConsoleDisplay.h"
+#include "../ColumnKernels.h"
+#include "../LiveSlots.h"
+#include "../ActivitySnapshot.h"
+#include "../DueDateIndex.h"
+#include "../ObserverDispatcher.h"
+#include "../MpscQueue.h"
+#include "../TodoListStore.h"
+#include <chrono>
+#include <random>
+#include <map>
+#include <set>
+#include <thread>
+#include <atomic>
+#include <sstream>
+#include <filesystem>
 #include <iostream>
+#include <functional>
 
 TEST(ActivityTest, Serialization) {
     std::cout << "\nRunning Serialization test...\n";
@@ -32,6 +50,32 @@ TEST(ActivityTest, Deserialization) {
     std::cout << "Deserialization test PASSED!\n";
 }
 
+TEST(ActivityTest, DeserializationErrors) {
+    std::cout << "\nRunning DeserializationErrors test...\n";
+
+    // A round trip through serialize() keeps every field
+    Activity original("Round trip", true, 1700000000);
+    Activity copy = Activity::deserialize(original.serialize());
+    EXPECT_EQ(copy.getDescription(), "Round trip");
+    EXPECT_TRUE(copy.isCompleted());
+    EXPECT_EQ(copy.getDueDate(), 1700000000);
+
+    EXPECT_THROW(Activity::deserialize("No separators"), std::invalid_argument);
+    EXPECT_THROW(Activity::deserialize("Task;1"), std::invalid_argument);
+    EXPECT_THROW(Activity::deserialize("Task;1;"), std::invalid_argument);
+    EXPECT_THROW(Activity::deserialize("Task;1;99999999999999999999999"), std::out_of_range);
+
+    // The message points at the offending character
+    try {
+        (void)Activity::deserialize("Task;0;17x0");
+        FAIL() << "Expected std::invalid_argument";
+    } catch (const std::invalid_argument& e) {
+        EXPECT_NE(std::string(e.what()).find("position 9"), std::string::npos);
+    }
+
+    std::cout << "DeserializationErrors test PASSED!\n";
+}
+
 // Test adding activities from the TodoList
 TEST(TodoListTest, AddActivity) {
     std::cout << "\nRunning AddActivity test...\n";
@@ -402,4 +446,1814 @@ TEST(MultipleTodoListsTest, SaveAndLoadMultipleLists) {
     EXPECT_EQ(loadedPersonal.getActivities()[0].getDescription(), "Read book");
 
     std::cout << "SaveAndLoadMultipleLists test PASSED!\n";
-}
\ No newline at end of file
+}
+
+// Test saving and loading activities in the binary columnar format
+TEST(TodoListTest, SaveAndLoadBinaryFile) {
+    std::cout << "\nRunning SaveAndLoadBinaryFile test...\n";
+
+    TodoList todoList("TestList");
+    todoList.addActivity(Activity("Activity 1", false, 1700000000));
+    todoList.addActivity(Activity("Activity 2", true, 1700005000));
+    todoList.addActivity(Activity("", true, 0)); // Empty description is a valid blob entry
+
+    std::string filename = "testfile.bin";
+    todoList.saveToFile(filename, FileFormat::Binary);
+
+    // The format is detected from the magic bytes, no hint needed on load
+    TodoList loadedList("LoadedList");
+    loadedList.loadFromFile(filename);
+
+    ASSERT_EQ(3, loadedList.getActivities().size());
+    EXPECT_EQ("Activity 1", loadedList.getActivities()[0].getDescription());
+    EXPECT_FALSE(loadedList.getActivities()[0].isCompleted());
+    EXPECT_EQ(1700000000, loadedList.getActivities()[0].getDueDate());
+
+    EXPECT_EQ("Activity 2", loadedList.getActivities()[1].getDescription());
+    EXPECT_TRUE(loadedList.getActivities()[1].isCompleted());
+    EXPECT_EQ(1700005000, loadedList.getActivities()[1].getDueDate());
+
+    EXPECT_EQ("", loadedList.getActivities()[2].getDescription());
+    EXPECT_TRUE(loadedList.getActivities()[2].isCompleted());
+
+    std::remove(filename.c_str());
+
+    std::cout << "SaveAndLoadBinaryFile test PASSED!\n";
+}
+
+// Test that a truncated binary file is rejected and leaves the list untouched
+TEST(TodoListTest, LoadTruncatedBinaryFile) {
+    std::cout << "\nRunning LoadTruncatedBinaryFile test...\n";
+
+    std::string filename = "truncated.bin";
+    {
+        std::ofstream file(filename, std::ios::binary);
+        BinaryFileHeader header{{'T', 'D', 'L', 'B'}, BINARY_FORMAT_VERSION, 5};
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    }
+
+    TodoList todoList("TestList");
+    todoList.addActivity(Activity("Keep me"));
+    EXPECT_THROW(todoList.loadFromFile(filename), std::runtime_error);
+    EXPECT_EQ(todoList.getTotalActivities(), 1);
+
+    // Counts far beyond the file size are rejected before anything is allocated for them
+    for (uint64_t count : {uint64_t{1} << 61, uint64_t{1} << 33, uint64_t{1}}) {
+        BinaryFileHeader header{{'T', 'D', 'L', 'B'}, BINARY_FORMAT_VERSION, count};
+        std::istringstream in(std::string(reinterpret_cast<const char*>(&header), sizeof(header)));
+        EXPECT_THROW((void)readBinaryActivities(in), std::runtime_error);
+    }
+
+    std::remove(filename.c_str());
+
+    std::cout << "LoadTruncatedBinaryFile test PASSED!\n";
+}
+
+// Test memory-mapped loading: activities are read in place and only edits are copied
+TEST(MappedTodoListTest, MapAndEditBinaryFile) {
+    std::cout << "\nRunning MapAndEditBinaryFile test...\n";
+
+    TodoList todoList("TestList");
+    todoList.addActivity(Activity("Activity 1", false, 1700000000));
+    todoList.addActivity(Activity("Activity 2", true, 1700005000));
+
+    std::string filename = "mapped.bin";
+    todoList.saveToFile(filename, FileFormat::Binary);
+
+    {
+        MappedTodoList mapped(filename);
+        ASSERT_EQ(mapped.size(), 2);
+        EXPECT_EQ(mapped.at(0).description, "Activity 1");
+        EXPECT_FALSE(mapped.at(0).completed);
+        EXPECT_EQ(mapped.at(1).description, "Activity 2");
+        EXPECT_TRUE(mapped.at(1).completed);
+        EXPECT_EQ(mapped.at(1).dueDate, 1700005000);
+        EXPECT_THROW((void)mapped.at(2), std::out_of_range);
+
+        // Editing materializes only the touched activity
+        EXPECT_EQ(mapped.getEditedActivities(), 0);
+        mapped.edit(0).setDescription("Edited");
+        EXPECT_EQ(mapped.getEditedActivities(), 1);
+        EXPECT_EQ(mapped.at(0).description, "Edited");
+        EXPECT_EQ(mapped.at(1).description, "Activity 2");
+
+        TodoList materialized = mapped.toTodoList("Materialized");
+        ASSERT_EQ(materialized.getTotalActivities(), 2);
+        EXPECT_EQ(materialized.getActivities()[0].getDescription(), "Edited");
+    }
+
+    // Text files cannot be mapped
+    todoList.saveToFile(filename);
+    EXPECT_THROW(MappedTodoList{filename}, std::runtime_error);
+
+    std::remove(filename.c_str());
+
+    std::cout << "MapAndEditBinaryFile test PASSED!\n";
+}
+
+// Test that journaled mutations are replayed on top of the snapshot when loading
+TEST(TodoListTest, JournalReplay) {
+    std::cout << "\nRunning JournalReplay test...\n";
+
+    std::string snapshot = "journal_snapshot.bin";
+    {
+        TodoList todoList("Journaled");
+        todoList.addActivity(Activity("Before journal", false, 1700000000));
+        todoList.enableJournal(snapshot, FileFormat::Binary, 100);
+
+        todoList.addActivity(Activity("Task A", false, 1700000100));
+        todoList.addActivity(Activity("Task B", false, 1700000200));
+        todoList.markActivityAsCompleted("Task A");
+        todoList.editActivity("Task B", "Task B edited", false, false, true, 1700000300);
+        todoList.removeActivity("1", true);
+        todoList.setName("Renamed");
+        // No explicit save: the snapshot only holds "Before journal", the rest is in the journal
+    }
+
+    // A torn record at the tail (crash mid-append) is ignored
+    {
+        std::ofstream journal(Journal::pathFor(snapshot), std::ios::app | std::ios::binary);
+        journal.write("\x40\x00\x00\x00garbage", 11);
+    }
+
+    TodoList loadedList("Other");
+    loadedList.loadFromFile(snapshot);
+
+    EXPECT_EQ(loadedList.getName(), "Renamed");
+    ASSERT_EQ(loadedList.getTotalActivities(), 2);
+    EXPECT_EQ(loadedList.getActivities()[0].getDescription(), "Task A");
+    EXPECT_TRUE(loadedList.getActivities()[0].isCompleted());
+    EXPECT_EQ(loadedList.getActivities()[1].getDescription(), "Task B edited");
+    EXPECT_EQ(loadedList.getActivities()[1].getDueDate(), 1700000300);
+
+    std::remove(snapshot.c_str());
+    std::remove(Journal::pathFor(snapshot).c_str());
+
+    std::cout << "JournalReplay test PASSED!\n";
+}
+
+// Test that the journal is folded into the snapshot once it reaches the checkpoint interval
+TEST(TodoListTest, JournalCheckpoint) {
+    std::cout << "\nRunning JournalCheckpoint test...\n";
+
+    std::string snapshot = "journal_checkpoint.txt";
+    TodoList todoList("Journaled");
+    todoList.enableJournal(snapshot, FileFormat::Text, 3);
+    EXPECT_TRUE(todoList.isJournalEnabled());
+
+    for (int i = 0; i < 10; ++i) {
+        todoList.addActivity(Activity("Task " + std::to_string(i)));
+    }
+    EXPECT_LE(Journal::read(Journal::pathFor(snapshot)).size(), 5); // Checkpoint header plus up to 4 records
+
+    // Copies never share the journal
+    TodoList copy = todoList;
+    EXPECT_FALSE(copy.isJournalEnabled());
+
+    todoList.disableJournal();
+    EXPECT_FALSE(todoList.isJournalEnabled());
+
+    TodoList loadedList("Other");
+    loadedList.loadFromFile(snapshot);
+    EXPECT_EQ(loadedList.getTotalActivities(), 10);
+    EXPECT_EQ(loadedList.getName(), "Journaled");
+
+    std::remove(snapshot.c_str());
+    std::remove(Journal::pathFor(snapshot).c_str());
+
+    std::cout << "JournalCheckpoint test PASSED!\n";
+}
+
+// Test that each sync mode fsyncs as often as it promises, and that synced journals replay like the others
+TEST(TodoListTest, JournalSyncModes) {
+    std::cout << "\nRunning JournalSyncModes test...\n";
+
+    const std::string path = "journal_sync.journal";
+    {
+        Journal process(path);
+        process.appendSetName("A");
+        process.sync();
+        EXPECT_EQ(process.getSyncCount(), 0);
+    }
+    {
+        Journal record(path, JournalSync::Record);
+        record.appendSetName("A");
+        record.appendSetName("B");
+        EXPECT_EQ(record.getSyncCount(), 2);
+    }
+    {
+        Journal mutation(path, JournalSync::Mutation);
+        mutation.appendSetName("A");
+        mutation.appendSetName("B");
+        EXPECT_EQ(mutation.getSyncCount(), 0);
+        mutation.sync();
+        mutation.sync(); // Nothing new to sync
+        EXPECT_EQ(mutation.getSyncCount(), 1);
+    }
+    EXPECT_EQ(Journal::read(path).size(), 5);
+    std::remove(path.c_str());
+
+    const std::string snapshot = "journal_sync.bin";
+    {
+        TodoList todoList("Synced");
+        todoList.enableJournal(snapshot, FileFormat::Binary, 1000, JournalSync::Mutation);
+        std::vector<Activity> bulk;
+        for (int i = 0; i < 50; ++i) {
+            bulk.emplace_back("Bulk " + std::to_string(i), false, 1000 + i);
+        }
+        todoList.addActivities(bulk);
+        {
+            TodoList::Batch batch(todoList);
+            todoList.addActivity(Activity("In batch", false, 2000));
+            todoList.markActivityAsCompleted("Bulk 0");
+        }
+        todoList.setName("Synced renamed");
+    }
+    TodoList loaded("Loaded");
+    loaded.loadFromFile(snapshot);
+    EXPECT_EQ(loaded.getTotalActivities(), 51);
+    EXPECT_EQ(loaded.getCompletedActivities(), 1);
+    EXPECT_EQ(loaded.getName(), "Synced renamed");
+    std::remove(snapshot.c_str());
+    std::remove(Journal::pathFor(snapshot).c_str());
+
+    std::cout << "JournalSyncModes test PASSED!\n";
+}
+
+// Test that a journal is only replayed onto the snapshot it was written after
+TEST(TodoListTest, StaleJournalIsIgnored) {
+    std::cout << "\nRunning StaleJournalIsIgnored test...\n";
+
+    const std::string snapshot = "journal_stale.bin";
+    const std::string journalPath = Journal::pathFor(snapshot);
+    auto readFile = [](const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        return std::string((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    };
+
+    // Crash after a checkpoint renamed the new snapshot into place, before it truncated the journal
+    TodoList todoList("Journaled");
+    todoList.enableJournal(snapshot, FileFormat::Binary, 100);
+    for (int i = 0; i < 3; ++i) {
+        todoList.addActivity(Activity("Task " + std::to_string(i), false, 1000 + i));
+    }
+    const std::string journalBeforeCheckpoint = readFile(journalPath);
+    todoList.checkpoint();
+    {
+        std::ofstream journal(journalPath, std::ios::binary | std::ios::trunc);
+        journal << journalBeforeCheckpoint;
+    }
+    TodoList recovered("Recovered");
+    recovered.loadFromFile(snapshot);
+    EXPECT_EQ(recovered.getTotalActivities(), 3);
+
+    // A journal left behind by disableJournal() is retired by a plain save over its snapshot
+    todoList.setName("Renamed in journal");
+    todoList.disableJournal();
+    TodoList other("Other");
+    other.addActivity(Activity("Only one", false, 1000));
+    other.saveToFile(snapshot, FileFormat::Binary);
+    TodoList loaded("Loaded");
+    loaded.loadFromFile(snapshot);
+    EXPECT_EQ(loaded.getTotalActivities(), 1);
+    EXPECT_EQ(loaded.getName(), "Loaded");
+
+    // So is a journal without a Checkpoint to tie it to the snapshot
+    std::remove(journalPath.c_str());
+    {
+        Journal headerless(journalPath);
+        headerless.appendAdd(Activity("Not replayed", false, 1000));
+        headerless.appendSetName("Not replayed either");
+    }
+    TodoList unreplayed("Unreplayed");
+    unreplayed.loadFromFile(snapshot);
+    EXPECT_EQ(unreplayed.getTotalActivities(), 1);
+    EXPECT_EQ(unreplayed.getName(), "Unreplayed");
+
+    std::remove(snapshot.c_str());
+    std::remove(journalPath.c_str());
+
+    std::cout << "StaleJournalIsIgnored test PASSED!\n";
+}
+
+// Test that name lookups stay correct after removals, renames and reloads
+TEST(TodoListTest, NameIndexAfterMutations) {
+    std::cout << "\nRunning NameIndexAfterMutations test...\n";
+
+    TodoList todoList("TestList");
+    todoList.addActivity(Activity("Alpha", false, 1));
+    todoList.addActivity(Activity("Beta", false, 2));
+    todoList.addActivity(Activity("Alpha", false, 3));
+    todoList.addActivity(Activity("Gamma", false, 4));
+
+    // Removing the first activity shifts the others: lookups must follow
+    todoList.removeActivity("1", true);
+    ASSERT_EQ(todoList.findActivitiesByName("Alpha").size(), 1);
+    EXPECT_EQ(todoList.findActivitiesByName("Alpha")[0].getDueDate(), 3);
+
+    todoList.markActivityAsCompleted("Gamma");
+    EXPECT_TRUE(todoList.getActivities()[2].isCompleted());
+
+    // Renaming moves the activity from one name bucket to another
+    EXPECT_TRUE(todoList.editActivity("Beta", "Alpha", false, false, false, 0));
+    EXPECT_TRUE(todoList.findActivitiesByName("Beta").empty());
+    auto alphas = todoList.findActivitiesByName("Alpha");
+    ASSERT_EQ(alphas.size(), 2);
+    EXPECT_EQ(alphas[0].getDueDate(), 2); // Results keep list order
+    EXPECT_EQ(alphas[1].getDueDate(), 3);
+
+    std::string filename = "index_test.txt";
+    todoList.saveToFile(filename);
+    TodoList loadedList("LoadedList");
+    loadedList.loadFromFile(filename);
+    EXPECT_EQ(loadedList.findActivitiesByName("Alpha").size(), 2);
+    EXPECT_NO_THROW(loadedList.removeActivity("Gamma", true));
+    EXPECT_TRUE(loadedList.findActivitiesByName("Gamma").empty());
+    std::remove(filename.c_str());
+
+    std::cout << "NameIndexAfterMutations test PASSED!\n";
+}
+
+// Test range queries and upcoming activities over the due date index
+TEST(TodoListTest, FindActivitiesDueBetween) {
+    std::cout << "\nRunning FindActivitiesDueBetween test...\n";
+
+    TodoList todoList("TestList");
+    todoList.addActivity(Activity("Late", false, 500));
+    todoList.addActivity(Activity("Early", false, 100));
+    todoList.addActivity(Activity("Middle", true, 300));
+    todoList.addActivity(Activity("Middle twin", false, 300));
+
+    auto range = todoList.findActivitiesDueBetween(200, 500);
+    ASSERT_EQ(range.size(), 3);
+    EXPECT_EQ(range[0].getDescription(), "Middle");
+    EXPECT_EQ(range[1].getDescription(), "Middle twin"); // Same date: list order
+    EXPECT_EQ(range[2].getDescription(), "Late");
+
+    EXPECT_TRUE(todoList.findActivitiesDueBetween(600, 700).empty());
+    EXPECT_TRUE(todoList.findActivitiesDueBetween(500, 100).empty());
+
+    // Completed activities are skipped by nextDue
+    auto upcoming = todoList.nextDue(2, 200);
+    ASSERT_EQ(upcoming.size(), 2);
+    EXPECT_EQ(upcoming[0].getDescription(), "Middle twin");
+    EXPECT_EQ(upcoming[1].getDescription(), "Late");
+
+    // The index follows due date edits and removals
+    EXPECT_TRUE(todoList.editActivity("Late", "", false, false, true, 50));
+    todoList.removeActivity("Early", true);
+    auto all = todoList.findActivitiesDueBetween(0, 1000);
+    ASSERT_EQ(all.size(), 3);
+    EXPECT_EQ(all[0].getDescription(), "Late");
+    EXPECT_EQ(all[1].getDescription(), "Middle");
+    EXPECT_EQ(all[2].getDescription(), "Middle twin");
+
+    std::cout << "FindActivitiesDueBetween test PASSED!\n";
+}
+
+// Test that the due date order stays exact across many interleaved adds, re-dates, removals and queries
+TEST(TodoListTest, DueDateOrderUnderChurn) {
+    std::cout << "\nRunning DueDateOrderUnderChurn test...\n";
+
+    TodoList todoList("TestList");
+    std::mt19937 rng(42);
+    std::vector<ActivityId> ids;
+    auto expectSorted = [&todoList]() {
+        std::vector<Activity> expected = todoList.getActivities();
+        std::stable_sort(expected.begin(), expected.end(), [](const Activity& a, const Activity& b) {
+            return a.getDueDate() < b.getDueDate();
+        });
+        std::vector<Activity> actual = todoList.findActivitiesDueBetween(std::numeric_limits<std::time_t>::min(),
+                                                                          std::numeric_limits<std::time_t>::max());
+        ASSERT_EQ(actual.size(), expected.size());
+        for (size_t i = 0; i < actual.size(); ++i) {
+            ASSERT_EQ(actual[i].getId(), expected[i].getId()) << "at " << i;
+        }
+    };
+
+    for (int step = 0; step < 6000; ++step) {
+        const unsigned op = rng() % 10;
+        if (op < 6 || ids.empty()) {
+            ids.push_back(todoList.addActivity(Activity("Task " + std::to_string(step), false, 10000 - step + rng() % 50)));
+        } else if (op < 9) {
+            EXPECT_TRUE(todoList.editActivity(ids[rng() % ids.size()], "", false, false, true, rng() % 10000));
+        } else {
+            const size_t victim = rng() % ids.size();
+            todoList.removeActivity(ids[victim]);
+            ids.erase(ids.begin() + static_cast<std::ptrdiff_t>(victim));
+        }
+        if (step % 997 == 0) expectSorted();
+    }
+    expectSorted();
+    EXPECT_EQ(todoList.snapshot()->toString(), todoList.toString());
+
+    // Bulk re-dates go through the same queue
+    todoList.editActivities([](const Activity& activity) { return activity.getDueDate() % 2 == 0; },
+                            ActivityPatch{std::nullopt, std::nullopt, 5000});
+    expectSorted();
+
+    std::cout << "DueDateOrderUnderChurn test PASSED!\n";
+}
+
+// Test the leaves of the due date index through splits and merges against a sorted set
+TEST(TodoListTest, DueDateIndexLeaves) {
+    std::cout << "\nRunning DueDateIndexLeaves test...\n";
+
+    DueDateIndex index;
+    std::set<std::pair<std::time_t, size_t>> model;
+    std::mt19937 rng(3);
+    for (size_t slot = 0; slot < 20000; ++slot) {
+        const std::time_t dueDate = rng() % 500;
+        index.insert(dueDate, slot);
+        model.emplace(dueDate, slot);
+        if (slot % 3 == 0) { // Erase a random entry, emptying and merging leaves along the way
+            auto victim = model.lower_bound({static_cast<std::time_t>(rng() % 500), 0});
+            if (victim == model.end()) victim = model.begin();
+            index.erase(victim->first, victim->second);
+            model.erase(victim);
+        }
+    }
+    auto expectModel = [&index, &model]() {
+        ASSERT_EQ(index.size(), model.size());
+        auto expected = model.begin();
+        for (auto it = index.begin(); it != index.end(); ++it, ++expected) {
+            ASSERT_EQ(it.dueDate(), expected->first);
+            ASSERT_EQ(*it, expected->second);
+        }
+    };
+    expectModel();
+
+    // Bulk merges interleave the new entries with the existing ones
+    std::vector<DueDateIndex::Entry> bulk;
+    for (size_t slot = 20000; slot < 30000; ++slot) bulk.emplace_back(rng() % 600, slot);
+    std::sort(bulk.begin(), bulk.end());
+    index.merge(bulk);
+    model.insert(bulk.begin(), bulk.end());
+    expectModel();
+
+    auto from = index.lowerBound(250);
+    EXPECT_EQ(*from, model.lower_bound({250, 0})->second);
+    EXPECT_EQ(index.lowerBound(600), index.end());
+    EXPECT_EQ(static_cast<size_t>(std::distance(index.lowerBound(100), index.lowerBound(200))),
+              static_cast<size_t>(std::distance(model.lower_bound({100, 0}), model.lower_bound({200, 0}))));
+
+    // Removing everything leaves no empty leaf behind
+    for (const auto& [dueDate, slot] : model) index.erase(dueDate, slot);
+    EXPECT_TRUE(index.empty());
+    EXPECT_EQ(index.begin(), index.end());
+
+    std::cout << "DueDateIndexLeaves test PASSED!\n";
+}
+
+// Test that views expose the stored activities without copying them
+TEST(TodoListTest, ActivityViews) {
+    std::cout << "\nRunning ActivityViews test...\n";
+
+    TodoList todoList("TestList");
+    todoList.addActivity(Activity("Workout", false, 300));
+    todoList.addActivity(Activity("Shopping", true, 100));
+    todoList.addActivity(Activity("Workout", true, 200));
+
+    ActivitySpan all = todoList.viewActivities();
+    ASSERT_EQ(all.size(), 3);
+    EXPECT_EQ(&all[0], &todoList.viewActivities()[0]); // Same storage, no copy
+    EXPECT_EQ(all[1].getDescription(), "Shopping");
+
+    ActivityPositionsView workouts = todoList.viewActivitiesByName("Workout");
+    ASSERT_EQ(workouts.size(), 2);
+    EXPECT_EQ(workouts[0].getDueDate(), 300);
+    EXPECT_EQ(workouts.begin().position(), 0);
+    EXPECT_TRUE(todoList.viewActivitiesByName("Nonexistent").empty());
+
+    ActivityDueDateView byDate = todoList.viewActivitiesDueBetween(100, 200);
+    ASSERT_EQ(byDate.size(), 2);
+    EXPECT_EQ(byDate[0].getDescription(), "Shopping");
+    EXPECT_EQ(byDate[1].getDescription(), "Workout");
+
+    size_t pending = 0;
+    for (const Activity& activity : todoList.viewActivitiesWhere([](const Activity& a) { return !a.isCompleted(); })) {
+        EXPECT_FALSE(activity.isCompleted());
+        ++pending;
+    }
+    EXPECT_EQ(pending, todoList.getPendingActivities());
+
+    std::cout << "ActivityViews test PASSED!\n";
+}
+
+// Test that a batch coalesces all notifications into a single one
+TEST(TodoListTest, BatchNotifications) {
+    std::cout << "\nRunning BatchNotifications test...\n";
+
+    TodoList todoList("TestList");
+    MockObserver observer;
+    todoList.addObserver(&observer);
+
+    {
+        TodoList::Batch batch(todoList);
+        for (int i = 0; i < 1000; ++i) {
+            todoList.addActivity(Activity("Task " + std::to_string(i)));
+        }
+        {
+            TodoList::Batch nested(todoList); // Nested scopes do not notify on their own
+            todoList.markActivityAsCompleted("1");
+        }
+        todoList.setName("Imported");
+        EXPECT_EQ(observer.updateCount, 0);
+    }
+    EXPECT_EQ(observer.updateCount, 1);
+    EXPECT_EQ(todoList.getTotalActivities(), 1000);
+
+    // A batch without changes does not notify
+    {
+        TodoList::Batch batch(todoList);
+    }
+    EXPECT_EQ(observer.updateCount, 1);
+
+    // Outside a batch every mutation notifies again
+    todoList.addActivity(Activity("After batch"));
+    EXPECT_EQ(observer.updateCount, 2);
+
+    std::cout << "BatchNotifications test PASSED!\n";
+}
+
+// Test that observers receive typed events describing each change
+TEST(TodoListTest, ChangeEvents) {
+    std::cout << "\nRunning ChangeEvents test...\n";
+
+    TodoList todoList("TestList");
+    MockChangeObserver observer;
+    MockObserver legacyObserver;
+    todoList.addObserver(&observer);
+    todoList.addObserver(&legacyObserver);
+
+    todoList.addActivity(Activity("Task A", false, 100));
+    todoList.addActivity(Activity("Task B", false, 200));
+    todoList.markActivityAsCompleted("Task B");
+    todoList.editActivity("1", "Task A edited", false, false, false, 0);
+    todoList.removeActivity("1", true);
+    todoList.setName("Renamed");
+
+    ASSERT_EQ(observer.events.size(), 6);
+    EXPECT_EQ(observer.updateCount, 0); // onChange replaces update() for this observer
+
+    EXPECT_EQ(observer.events[0].type, ChangeType::Added);
+    EXPECT_EQ(observer.events[0].index, 0);
+    EXPECT_EQ(observer.events[0].newValue->getDescription(), "Task A");
+
+    EXPECT_EQ(observer.events[2].type, ChangeType::Completed);
+    EXPECT_EQ(observer.events[2].index, 1);
+    EXPECT_FALSE(observer.events[2].oldValue->isCompleted());
+    EXPECT_TRUE(observer.events[2].newValue->isCompleted());
+
+    EXPECT_EQ(observer.events[3].type, ChangeType::Edited);
+    EXPECT_EQ(observer.events[3].oldValue->getDescription(), "Task A");
+    EXPECT_EQ(observer.events[3].newValue->getDescription(), "Task A edited");
+
+    EXPECT_EQ(observer.events[4].type, ChangeType::Removed);
+    EXPECT_EQ(observer.events[4].index, 0);
+    EXPECT_EQ(observer.events[4].oldValue->getDescription(), "Task A edited");
+
+    EXPECT_EQ(observer.events[5].type, ChangeType::Renamed);
+    EXPECT_EQ(observer.events[5].oldName, "TestList");
+    EXPECT_EQ(observer.events[5].newName, "Renamed");
+
+    // Legacy observers still get one update() per change
+    EXPECT_EQ(legacyObserver.updateCount, 6);
+
+    // A batch is reported as a single Reloaded event
+    {
+        TodoList::Batch batch(todoList);
+        todoList.addActivity(Activity("Task C"));
+        todoList.addActivity(Activity("Task D"));
+    }
+    ASSERT_EQ(observer.events.size(), 7);
+    EXPECT_EQ(observer.events[6].type, ChangeType::Reloaded);
+
+    std::cout << "ChangeEvents test PASSED!\n";
+}
+
+// Test that the incremental display only prints the lines that changed
+TEST(ConsoleDisplayTest, IncrementalRendering) {
+    std::cout << "\nRunning IncrementalRendering test...\n";
+
+    TodoList todoList("TestList");
+    todoList.addActivity(Activity("Task A", false, 100));
+
+    std::ostringstream output;
+    ConsoleDisplay display(todoList, DisplayMode::Incremental, std::chrono::milliseconds(0), output);
+
+    todoList.addActivity(Activity("Task B", false, 200));
+    EXPECT_NE(output.str().find("+ Task B [Not Done]"), std::string::npos);
+    EXPECT_EQ(output.str().find("Task A"), std::string::npos); // Unchanged lines are not re-printed
+
+    output.str("");
+    todoList.markActivityAsCompleted("Task A");
+    EXPECT_NE(output.str().find("~ Task A [Done]"), std::string::npos);
+
+    // Completing it again renders nothing since the line is unchanged
+    output.str("");
+    todoList.markActivityAsCompleted("Task A");
+    EXPECT_TRUE(output.str().empty());
+
+    todoList.removeActivity("1", true);
+    EXPECT_NE(output.str().find("- Task A [Done]"), std::string::npos);
+
+    // A batch re-renders the whole list once
+    output.str("");
+    {
+        TodoList::Batch batch(todoList);
+        todoList.addActivity(Activity("Task C", false, 300));
+    }
+    EXPECT_NE(output.str().find("--- Todo List: TestList ---"), std::string::npos);
+
+    std::cout << "IncrementalRendering test PASSED!\n";
+}
+
+// Test that the throttle holds renders back until flush()
+TEST(ConsoleDisplayTest, ThrottledRendering) {
+    std::cout << "\nRunning ThrottledRendering test...\n";
+
+    TodoList todoList("TestList");
+    std::ostringstream output;
+    ConsoleDisplay display(todoList, DisplayMode::Full, std::chrono::hours(1), output);
+
+    todoList.addActivity(Activity("Task 1")); // First change renders immediately
+    std::string afterFirst = output.str();
+    EXPECT_NE(afterFirst.find("Task 1"), std::string::npos);
+
+    for (int i = 2; i <= 100; ++i) {
+        todoList.addActivity(Activity("Task " + std::to_string(i)));
+    }
+    EXPECT_EQ(output.str(), afterFirst); // Held back by the throttle
+
+    display.flush();
+    EXPECT_NE(output.str().find("Task 100"), std::string::npos);
+
+    std::cout << "ThrottledRendering test PASSED!\n";
+}
+
+// Test that a text file parsed in parallel chunks keeps file order
+TEST(TodoListTest, ParallelLoadFromFile) {
+    std::cout << "\nRunning ParallelLoadFromFile test...\n";
+
+    TodoList todoList("TestList");
+    {
+        TodoList::Batch batch(todoList);
+        for (int i = 0; i < 20000; ++i) { // Large enough to be split into several chunks
+            todoList.addActivity(Activity("Task " + std::to_string(i), i % 2 == 0, 1700000000 + i));
+        }
+    }
+    std::string filename = "parallel_load.txt";
+    todoList.saveToFile(filename);
+
+    TodoList loadedList("LoadedList");
+    MockObserver observer;
+    loadedList.addObserver(&observer);
+    loadedList.loadFromFile(filename, 4);
+
+    EXPECT_EQ(observer.updateCount, 1); // A single notification for the whole load
+    ASSERT_EQ(loadedList.getTotalActivities(), 20000);
+    ActivitySpan loaded = loadedList.viewActivities();
+    for (size_t i = 0; i < loaded.size(); ++i) {
+        ASSERT_EQ(loaded[i].getDescription(), "Task " + std::to_string(i));
+        ASSERT_EQ(loaded[i].getDueDate(), static_cast<std::time_t>(1700000000 + i));
+    }
+
+    // A malformed line anywhere fails the whole load
+    {
+        std::ofstream file(filename, std::ios::app);
+        file << "broken line\n";
+    }
+    EXPECT_THROW(loadedList.loadFromFile(filename, 4), std::invalid_argument);
+    EXPECT_EQ(loadedList.getTotalActivities(), 20000);
+
+    std::remove(filename.c_str());
+
+    std::cout << "ParallelLoadFromFile test PASSED!\n";
+}
+
+// Test that parallel serialization produces exactly the sequential output
+TEST(TodoListTest, ParallelSaveMatchesSequential) {
+    std::cout << "\nRunning ParallelSaveMatchesSequential test...\n";
+
+    std::vector<Activity> activities;
+    for (int i = 0; i < 50000; ++i) { // Several blocks per thread
+        activities.emplace_back("Task " + std::to_string(i), i % 3 == 0, 1700000000 + i);
+    }
+
+    std::ostringstream sequential;
+    std::ostringstream parallel;
+    writeTextActivities(sequential, activities, 1);
+    writeTextActivities(parallel, activities, 4);
+    EXPECT_EQ(sequential.str(), parallel.str());
+
+    // Same format as serialize(), one activity per line
+    std::string expectedStart = activities[0].serialize() + "\n" + activities[1].serialize() + "\n";
+    EXPECT_EQ(parallel.str().compare(0, expectedStart.size(), expectedStart), 0);
+
+    std::cout << "ParallelSaveMatchesSequential test PASSED!\n";
+}
+
+// Test atomic saves: the target is replaced in one step and failures are reported
+TEST(TodoListTest, AtomicSave) {
+    std::cout << "\nRunning AtomicSave test...\n";
+
+    TodoList todoList("TestList");
+    todoList.addActivity(Activity("Old content", false, 1700000000));
+    std::string filename = "atomic_save.txt";
+    todoList.saveToFile(filename);
+
+    todoList.addActivity(Activity("New content", true, 1700000500));
+    EXPECT_NO_THROW(todoList.saveToFile(filename, FileFormat::Binary, SaveMode::Atomic));
+
+    TodoList loadedList("LoadedList");
+    loadedList.loadFromFile(filename);
+    ASSERT_EQ(loadedList.getTotalActivities(), 2);
+    EXPECT_EQ(loadedList.getActivities()[1].getDescription(), "New content");
+
+    // No temporary file is left next to the target
+    for (const auto& entry : std::filesystem::directory_iterator(".")) {
+        EXPECT_EQ(entry.path().filename().string().find("atomic_save.txt.tmp"), std::string::npos);
+    }
+
+    // Replacing a file keeps its permissions, and a new file gets the ones the umask gives it
+    namespace fs = std::filesystem;
+    fs::permissions(filename, fs::perms::owner_read | fs::perms::owner_write | fs::perms::group_read | fs::perms::others_read);
+    todoList.saveToFile(filename, FileFormat::Text, SaveMode::Atomic);
+    EXPECT_EQ(fs::status(filename).permissions(),
+              fs::perms::owner_read | fs::perms::owner_write | fs::perms::group_read | fs::perms::others_read);
+    const std::string fresh = "atomic_save_new.txt";
+    todoList.saveToFile(fresh);
+    const fs::perms expected = fs::status(fresh).permissions();
+    std::remove(fresh.c_str());
+    todoList.saveToFile(fresh, FileFormat::Text, SaveMode::Atomic);
+    EXPECT_EQ(fs::status(fresh).permissions(), expected);
+    std::remove(fresh.c_str());
+
+    // Failures are reported instead of being printed and ignored
+    EXPECT_THROW(todoList.saveToFile("missing_dir/list.txt", FileFormat::Text, SaveMode::Atomic), std::runtime_error);
+    EXPECT_THROW(todoList.saveToFile("missing_dir/list.txt"), std::runtime_error);
+
+    std::remove(filename.c_str());
+
+    std::cout << "AtomicSave test PASSED!\n";
+}
+
+// Test that the packed columns stay in sync with the activities across word boundaries
+TEST(TodoListTest, ColumnCountsMatchActivities) {
+    std::cout << "\nRunning ColumnCountsMatchActivities test...\n";
+
+    TodoList todoList("TestList");
+    for (int i = 0; i < 300; ++i) {
+        todoList.addActivity(Activity("Task " + std::to_string(i), i % 5 == 0, 1000 + i));
+    }
+    // Remove from the front, the middle and around 64-bit word boundaries
+    for (const char* index : {"1", "64", "65", "128", "150", "2"}) {
+        todoList.removeActivity(index, true);
+    }
+    todoList.markActivityAsCompleted("10");
+    todoList.editActivity("20", "", true, false, true, 5000);
+
+    auto expectedPending = [&]() {
+        size_t pending = 0;
+        for (const Activity& a : todoList.getActivities()) pending += !a.isCompleted();
+        return pending;
+    };
+    auto expectedOverdue = [&](std::time_t now) {
+        size_t overdue = 0;
+        for (const Activity& a : todoList.getActivities()) overdue += !a.isCompleted() && a.getDueDate() < now;
+        return overdue;
+    };
+
+    EXPECT_EQ(todoList.getPendingActivities(), expectedPending());
+    for (std::time_t now : {0, 1000, 1100, 1250, 1300, 6000}) {
+        EXPECT_EQ(todoList.getOverdueActivities(now), expectedOverdue(now));
+    }
+
+    std::cout << "ColumnCountsMatchActivities test PASSED!\n";
+}
+
+// Test that every SIMD kernel level supported by this CPU agrees with the scalar kernels
+TEST(TodoListTest, ColumnKernelsMatchScalar) {
+    std::cout << "\nRunning ColumnKernelsMatchScalar test...\n";
+
+    // Odd sizes exercise the vector tails; extreme dates exercise the comparison edge cases
+    std::vector<int64_t> dueDates;
+    std::vector<uint64_t> completedBits((517 + 63) / 64, 0);
+    for (size_t i = 0; i < 517; ++i) {
+        dueDates.push_back(static_cast<int64_t>((i * 7919) % 1000) - 500);
+        if (i % 3 == 0) completedBits[i / 64] |= uint64_t{1} << (i % 64);
+    }
+    dueDates[7] = INT64_MIN;
+    dueDates[8] = INT64_MAX;
+
+    const KernelLevel original = getKernelLevel();
+    setKernelLevel(KernelLevel::Scalar);
+    ASSERT_EQ(getKernelLevel(), KernelLevel::Scalar);
+    const size_t expectedCompleted = countSetBits(completedBits.data(), completedBits.size());
+    EXPECT_EQ(expectedCompleted, (517 + 2) / 3);
+
+    for (KernelLevel level : {KernelLevel::SSE42, KernelLevel::AVX2}) {
+        setKernelLevel(level);
+        EXPECT_EQ(countSetBits(completedBits.data(), completedBits.size()), expectedCompleted);
+        for (int64_t now : {INT64_MIN, int64_t{-500}, int64_t{0}, int64_t{499}, INT64_MAX}) {
+            for (size_t count : {size_t{0}, size_t{3}, size_t{64}, size_t{130}, dueDates.size()}) {
+                setKernelLevel(KernelLevel::Scalar);
+                const size_t expected = countOverdue(dueDates.data(), completedBits.data(), count, now);
+                setKernelLevel(level);
+                EXPECT_EQ(countOverdue(dueDates.data(), completedBits.data(), count, now), expected);
+            }
+        }
+    }
+    setKernelLevel(original);
+
+    std::cout << "ColumnKernelsMatchScalar test PASSED!\n";
+}
+
+// Test that the cached counters follow every mutation and a moving "now"
+TEST(TodoListTest, CachedCounters) {
+    std::cout << "\nRunning CachedCounters test...\n";
+
+    TodoList todoList("TestList");
+    for (int i = 0; i < 100; ++i) {
+        todoList.addActivity(Activity("Task " + std::to_string(i), i % 4 == 0, 1000 + 10 * i));
+    }
+    auto expectedOverdue = [&](std::time_t now) {
+        size_t overdue = 0;
+        for (const Activity& a : todoList.viewActivities()) overdue += !a.isCompleted() && a.getDueDate() < now;
+        return overdue;
+    };
+
+    EXPECT_EQ(todoList.getCompletedActivities(), 25);
+    EXPECT_EQ(todoList.getPendingActivities(), 75);
+    // now moves forward, stays, then jumps backwards
+    for (std::time_t now : {1000, 1205, 1205, 1500, 1995, 3000, 1100}) {
+        EXPECT_EQ(todoList.getOverdueActivities(now), expectedOverdue(now));
+    }
+
+    EXPECT_EQ(todoList.getOverdueActivities(1500), expectedOverdue(1500)); // Caches 1500 before the changes below
+    todoList.addActivity(Activity("Late", false, 1200));          // Already overdue
+    todoList.addActivity(Activity("Done late", true, 1200));      // Completed: never overdue
+    todoList.removeActivity("Task 31", true);                      // Pending and overdue
+    todoList.markActivityAsCompleted("Task 33");                   // Stops being overdue
+    todoList.editActivity("Task 99", "", false, false, true, 900); // Becomes overdue
+    todoList.editActivity("Task 0", "", true, false, false, 0);    // Reopened and overdue
+    EXPECT_EQ(todoList.getOverdueActivities(1500), expectedOverdue(1500));
+    EXPECT_EQ(todoList.getOverdueActivities(1800), expectedOverdue(1800));
+    EXPECT_EQ(todoList.getPendingActivities() + todoList.getCompletedActivities(), todoList.getTotalActivities());
+    EXPECT_TRUE(todoList.countersAreConsistent());
+
+    const std::string filename = "test_counters.txt";
+    todoList.saveToFile(filename);
+    TodoList loaded("Loaded");
+    loaded.addActivity(Activity("Replaced", true, 1));
+    loaded.loadFromFile(filename);
+    EXPECT_EQ(loaded.getCompletedActivities(), todoList.getCompletedActivities());
+    EXPECT_EQ(loaded.getOverdueActivities(1800), todoList.getOverdueActivities(1800));
+    std::remove(filename.c_str());
+
+    std::cout << "CachedCounters test PASSED!\n";
+}
+
+// Test that ids stay attached to their activities across removals, saves, loads and journal replay
+TEST(TodoListTest, StableActivityIds) {
+    std::cout << "\nRunning StableActivityIds test...\n";
+
+    TodoList todoList("TestList");
+    const ActivityId first = todoList.addActivity(Activity("First", false, 1000));
+    const ActivityId second = todoList.addActivity(Activity("Second", false, 2000));
+    const ActivityId third = todoList.addActivity(Activity("Third", false, 3000));
+    EXPECT_NE(first, 0);
+    EXPECT_NE(first, second);
+    EXPECT_NE(second, third);
+
+    // Positions shift, ids do not
+    todoList.removeActivity(first);
+    ASSERT_NE(todoList.findActivityById(third), nullptr);
+    EXPECT_EQ(todoList.findActivityById(third)->getDescription(), "Third");
+    EXPECT_EQ(todoList.findActivityById(first), nullptr);
+    EXPECT_THROW(todoList.removeActivity(first), std::out_of_range);
+
+    todoList.markActivityAsCompleted(third);
+    EXPECT_TRUE(todoList.findActivityById(third)->isCompleted());
+    EXPECT_TRUE(todoList.editActivity(second, "Second edited", false, false, true, 2500));
+    EXPECT_EQ(todoList.findActivityById(second)->getDueDate(), 2500);
+    EXPECT_FALSE(todoList.editActivity(first, "Gone", false, false, false, 0));
+
+    // Ids are never reused, even after the highest one was removed
+    todoList.removeActivity(third);
+    const ActivityId fourth = todoList.addActivity(Activity("Fourth", false, 4000));
+    EXPECT_GT(fourth, third);
+
+    // Both formats persist the ids
+    for (FileFormat format : {FileFormat::Text, FileFormat::Binary}) {
+        const std::string filename = "test_ids.dat";
+        todoList.saveToFile(filename, format);
+        TodoList loaded("Loaded");
+        loaded.loadFromFile(filename);
+        ASSERT_NE(loaded.findActivityById(second), nullptr);
+        EXPECT_EQ(loaded.findActivityById(second)->getDescription(), "Second edited");
+        ASSERT_NE(loaded.findActivityById(fourth), nullptr);
+        EXPECT_EQ(loaded.findActivityById(fourth)->getDescription(), "Fourth");
+        EXPECT_GT(loaded.addActivity(Activity("New", false, 0)), fourth);
+        std::remove(filename.c_str());
+    }
+    MappedTodoList mapped = [&]() {
+        todoList.saveToFile("test_ids.bin", FileFormat::Binary);
+        return MappedTodoList("test_ids.bin");
+    }();
+    EXPECT_EQ(mapped.at(1).id, fourth);
+    std::remove("test_ids.bin");
+
+    // Journal replay recreates the same ids
+    const std::string snapshot = "test_ids_journal.bin";
+    ActivityId journaled = 0;
+    {
+        TodoList journaling("Journaled");
+        journaling.enableJournal(snapshot);
+        journaling.addActivity(Activity("Keep", false, 1));
+        const ActivityId removed = journaling.addActivity(Activity("Drop", false, 2));
+        journaling.removeActivity(removed);
+        journaled = journaling.addActivity(Activity("Late", false, 3));
+    }
+    TodoList recovered("Recovered");
+    recovered.loadFromFile(snapshot);
+    ASSERT_NE(recovered.findActivityById(journaled), nullptr);
+    EXPECT_EQ(recovered.findActivityById(journaled)->getDescription(), "Late");
+    std::remove(snapshot.c_str());
+    std::remove(Journal::pathFor(snapshot).c_str());
+
+    // Text lines without an id are still accepted; malformed ids are rejected
+    EXPECT_EQ(Activity::deserialize("Task;1;100").getId(), 0);
+    EXPECT_EQ(Activity::deserialize("Task;1;100;42").getId(), 42);
+    EXPECT_THROW(Activity::deserialize("Task;1;100;"), std::invalid_argument);
+    EXPECT_THROW(Activity::deserialize("Task;1;100;4x"), std::invalid_argument);
+
+    std::cout << "StableActivityIds test PASSED!\n";
+}
+
+// Test the live slot index against a plain vector of flags
+TEST(TodoListTest, LiveSlotsRankAndSelect) {
+    std::cout << "\nRunning LiveSlotsRankAndSelect test...\n";
+
+    LiveSlots slots;
+    std::vector<bool> model;
+    std::mt19937 random(42);
+    for (int round = 0; round < 2000; ++round) {
+        if (model.empty() || random() % 3 != 0) {
+            slots.pushBack();
+            model.push_back(true);
+        } else {
+            size_t slot = random() % model.size();
+            if (model[slot]) {
+                slots.kill(slot);
+                model[slot] = false;
+            }
+        }
+    }
+
+    std::vector<size_t> liveModel;
+    for (size_t slot = 0; slot < model.size(); ++slot) {
+        ASSERT_EQ(slots.isLive(slot), model[slot]);
+        if (model[slot]) {
+            ASSERT_EQ(slots.rank(slot), liveModel.size());
+            liveModel.push_back(slot);
+        }
+    }
+    ASSERT_EQ(slots.liveCount(), liveModel.size());
+    for (size_t position = 0; position < liveModel.size(); ++position) {
+        ASSERT_EQ(slots.select(position), liveModel[position]);
+    }
+
+    slots.assign(100);
+    EXPECT_EQ(slots.liveCount(), 100);
+    EXPECT_EQ(slots.select(63), 63);
+    EXPECT_EQ(slots.rank(99), 99);
+
+    std::cout << "LiveSlotsRankAndSelect test PASSED!\n";
+}
+
+// Test that removals leave tombstones invisible to every accessor, before and after compaction
+TEST(TodoListTest, TombstoneRemoval) {
+    std::cout << "\nRunning TombstoneRemoval test...\n";
+
+    TodoList todoList("TestList");
+    MockChangeObserver observer;
+    todoList.addObserver(&observer);
+    std::vector<Activity> model;
+    for (int i = 0; i < 3000; ++i) {
+        Activity activity("Task " + std::to_string(i % 500), i % 7 == 0, 1000 + (i * 37) % 400);
+        activity.setId(todoList.addActivity(activity));
+        model.push_back(activity);
+    }
+
+    auto checkAgainstModel = [&]() {
+        ASSERT_EQ(todoList.getTotalActivities(), model.size());
+        const std::vector<Activity> activities = todoList.getActivities();
+        ActivitySpan view = todoList.viewActivities();
+        ASSERT_EQ(view.size(), model.size());
+        size_t i = 0;
+        for (const Activity& activity : view) {
+            ASSERT_EQ(activity.getId(), model[i].getId());
+            ASSERT_EQ(activities[i].getId(), model[i].getId());
+            ++i;
+        }
+        ASSERT_EQ(i, model.size());
+        if (!model.empty()) {
+            EXPECT_EQ(view[model.size() / 2].getId(), model[model.size() / 2].getId());
+        }
+
+        // Display order is by due date, ties in list order
+        std::vector<Activity> sorted = model;
+        std::stable_sort(sorted.begin(), sorted.end(), [](const Activity& a, const Activity& b) {
+            return a.getDueDate() < b.getDueDate();
+        });
+        std::string expected = "--- Todo List: TestList ---\n";
+        for (size_t n = 0; n < sorted.size(); ++n) {
+            expected += std::to_string(n + 1) + ". " + sorted[n].toString() + "\n";
+        }
+        EXPECT_EQ(todoList.toString(), expected);
+
+        size_t dueCount = 0;
+        for (const Activity& activity : model) dueCount += activity.getDueDate() >= 1100 && activity.getDueDate() <= 1200;
+        EXPECT_EQ(todoList.viewActivitiesDueBetween(1100, 1200).size(), dueCount);
+        size_t named = 0;
+        for (const Activity& activity : model) named += activity.getDescription() == "Task 3";
+        ActivityPositionsView byName = todoList.viewActivitiesByName("Task 3");
+        EXPECT_EQ(byName.size(), named);
+        for (auto it = byName.begin(); it != byName.end(); ++it) {
+            EXPECT_EQ(model[it.position()].getId(), it->getId());
+        }
+        EXPECT_TRUE(todoList.countersAreConsistent());
+    };
+
+    // Positional removals, with events reporting the list position
+    std::mt19937 random(7);
+    for (int i = 0; i < 900; ++i) {
+        size_t position = random() % model.size();
+        todoList.removeActivity(std::to_string(position + 1), true);
+        ASSERT_EQ(observer.events.back().type, ChangeType::Removed);
+        ASSERT_EQ(observer.events.back().index, position);
+        ASSERT_EQ(observer.events.back().oldValue->getId(), model[position].getId());
+        model.erase(model.begin() + static_cast<std::ptrdiff_t>(position));
+    }
+    checkAgainstModel();
+
+    // Positional edits see the same numbering
+    todoList.markActivityAsCompleted("10");
+    model[9].setCompleted(true);
+    EXPECT_EQ(observer.events.back().index, 9);
+    todoList.editActivity("20", "Edited", false, false, true, 50);
+    model[19].setDescription("Edited");
+    model[19].setDueDate(50);
+    checkAgainstModel();
+
+    // Saved files contain only live activities
+    const std::string filename = "tombstones.bin";
+    todoList.saveToFile(filename, FileFormat::Binary);
+    TodoList loaded("TestList");
+    loaded.loadFromFile(filename);
+    EXPECT_EQ(loaded.toString(), todoList.toString());
+    std::remove(filename.c_str());
+
+    // Enough removals to trigger the automatic compaction, then the rest through ids
+    while (model.size() > 500) {
+        todoList.removeActivity(model.front().getId());
+        model.erase(model.begin());
+    }
+    checkAgainstModel();
+    todoList.compact();
+    checkAgainstModel();
+    ASSERT_EQ(todoList.findActivityById(model.back().getId())->getDescription(), model.back().getDescription());
+
+    std::cout << "TombstoneRemoval test PASSED!\n";
+}
+
+// Test the bulk mutations: one notification each, and the same result as the single-item calls
+TEST(TodoListTest, BulkOperations) {
+    std::cout << "\nRunning BulkOperations test...\n";
+
+    const std::string snapshot = "bulk_journal.bin";
+    TodoList todoList("Bulk");
+    todoList.enableJournal(snapshot);
+    MockChangeObserver observer;
+    todoList.addObserver(&observer);
+
+    std::vector<Activity> imported;
+    for (int i = 0; i < 2000; ++i) {
+        imported.emplace_back("Task " + std::to_string(i % 10), i % 4 == 0, 5000 - (i * 13) % 1000);
+    }
+    EXPECT_EQ(todoList.addActivities(imported), 2000); // Copied: the source is left intact
+    EXPECT_EQ(imported[5].getDescription(), "Task 5");
+    std::vector<Activity> more = {Activity("Extra", false, 10), Activity("Extra", false, 1)};
+    EXPECT_EQ(todoList.addActivities(std::move(more)), 2);
+    EXPECT_EQ(observer.events.size(), 2);
+    EXPECT_EQ(observer.events.back().type, ChangeType::Reloaded);
+    EXPECT_EQ(todoList.getTotalActivities(), 2002);
+
+    // The same operations one at a time on a reference list
+    TodoList reference("Bulk");
+    {
+        TodoList::Batch batch(reference);
+        for (const Activity& activity : imported) reference.addActivity(activity);
+        reference.addActivity(Activity("Extra", false, 10));
+        reference.addActivity(Activity("Extra", false, 1));
+    }
+    EXPECT_EQ(todoList.toString(), reference.toString());
+
+    EXPECT_EQ(todoList.removeActivities([](const Activity& a) { return a.getDescription() == "Task 3"; }), 200);
+    size_t toComplete = 0;
+    for (const Activity& a : todoList.viewActivities()) toComplete += !a.isCompleted() && a.getDueDate() < 4500;
+    EXPECT_EQ(todoList.markActivitiesAsCompleted([](const Activity& a) { return a.getDueDate() < 4500; }), toComplete);
+    EXPECT_EQ(todoList.editActivities([](const Activity& a) { return a.getDescription() == "Task 7"; },
+                                      ActivityPatch{std::string("Renamed"), std::nullopt, 4242}), 200);
+    EXPECT_EQ(todoList.removeActivities([](const Activity&) { return false; }), 0);
+    EXPECT_EQ(observer.events.size(), 5); // Nothing changed: no notification
+
+    {
+        TodoList::Batch batch(reference);
+        for (size_t i = reference.getTotalActivities(); i > 0; --i) {
+            if (reference.viewActivities()[i - 1].getDescription() == "Task 3") reference.removeActivity(std::to_string(i), true);
+        }
+        for (size_t i = 1; i <= reference.getTotalActivities(); ++i) {
+            const Activity& activity = reference.viewActivities()[i - 1];
+            if (!activity.isCompleted() && activity.getDueDate() < 4500) reference.markActivityAsCompleted(std::to_string(i));
+            if (activity.getDescription() == "Task 7") reference.editActivity(std::to_string(i), "Renamed", false, false, true, 4242);
+        }
+    }
+    EXPECT_EQ(todoList.toString(), reference.toString());
+    EXPECT_EQ(todoList.viewActivitiesByName("Renamed").size(), 200);
+    EXPECT_TRUE(todoList.viewActivitiesByName("Task 7").empty());
+    EXPECT_EQ(todoList.findActivitiesByDueDate(4242).size(), reference.findActivitiesByDueDate(4242).size());
+    EXPECT_EQ(todoList.getPendingActivities(), reference.getPendingActivities());
+    EXPECT_TRUE(todoList.countersAreConsistent());
+
+    // The journal replays the bulk changes like single ones
+    TodoList recovered("Recovered");
+    recovered.loadFromFile(snapshot);
+    EXPECT_EQ(recovered.toString(), todoList.toString());
+    todoList.disableJournal();
+    std::remove(snapshot.c_str());
+    std::remove(Journal::pathFor(snapshot).c_str());
+
+    std::cout << "BulkOperations test PASSED!\n";
+}
+
+// Observer that reads the list from its callback, which would deadlock if notified under the write lock
+class ReadingObserver : public Observer {
+public:
+    explicit ReadingObserver(const TodoList& todoList) : list(todoList) {}
+    std::atomic<size_t> notifications{0};
+
+    void update() override {
+        (void)list.getTotalActivities();
+        ++notifications;
+    }
+
+private:
+    const TodoList& list;
+};
+
+TEST(TodoListTest, ConcurrentReadersAndWriter) {
+    std::cout << "\nRunning ConcurrentReadersAndWriter test...\n";
+
+    TodoList todoList("Shared");
+    todoList.setConcurrentMode(true);
+    EXPECT_TRUE(todoList.isConcurrentMode());
+    todoList.addActivity(Activity("Anchor", false, 1000));
+    ReadingObserver observer(todoList);
+    todoList.addObserver(&observer);
+
+    std::atomic<bool> writerDone{false};
+    std::atomic<size_t> readerErrors{0};
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 4; ++r) {
+        readers.emplace_back([&todoList, &writerDone, &readerErrors, r] {
+            while (!writerDone) {
+                // The anchor is never touched, so every read must see exactly one
+                if (todoList.findActivitiesByName("Anchor").size() != 1) ++readerErrors;
+                if (todoList.getPendingActivities() > todoList.getTotalActivities() + 1000) ++readerErrors;
+                switch (r) {
+                    case 0: if (todoList.toString().find("Anchor") == std::string::npos) ++readerErrors; break;
+                    case 1: (void)todoList.getOverdueActivities(1500); break;
+                    case 2: if (todoList.findActivitiesDueBetween(1000, 1000).empty()) ++readerErrors; break;
+                    default: (void)todoList.nextDue(5, 0); break;
+                }
+            }
+        });
+    }
+
+    std::vector<ActivityId> ids;
+    size_t changes = 0;
+    for (int i = 0; i < 600; ++i) {
+        ids.push_back(todoList.addActivity(Activity("Task " + std::to_string(i % 50), false, 500 + i)));
+        ++changes;
+        if (i % 3 == 0 && todoList.findActivityById(ids[i / 2])) {
+            todoList.markActivityAsCompleted(ids[i / 2]);
+            ++changes;
+        }
+        if (i % 5 == 0) changes += todoList.editActivity(ids[i / 4], "", false, false, true, 2000 + i);
+        if (i % 7 == 0) {
+            todoList.removeActivity(ids[i / 7 * 3]);
+            ++changes;
+        }
+        if (i % 100 == 0) {
+            // Bulk adds grow the storage, which must not happen under readers' feet
+            std::vector<Activity> imported(300, Activity("Imported", false, 3000 + i));
+            changes += todoList.addActivities(imported) > 0;
+        }
+    }
+    changes += todoList.removeActivities([](const Activity& a) { return a.getDescription() == "Task 13"; }) > 0;
+    writerDone = true;
+    for (std::thread& reader : readers) reader.join();
+
+    EXPECT_EQ(readerErrors, 0);
+    EXPECT_TRUE(todoList.countersAreConsistent());
+    EXPECT_EQ(observer.notifications, changes);
+    EXPECT_EQ(todoList.findActivitiesByName("Anchor").size(), 1);
+    todoList.removeObserver(&observer);
+
+    std::cout << "ConcurrentReadersAndWriter test PASSED!\n";
+}
+
+// Console input that runs a callback when the code under test first waits for the user
+class PromptInput : public std::streambuf {
+public:
+    PromptInput(std::string text, std::function<void()> whileTyping)
+        : input(std::move(text)), onFirstRead(std::move(whileTyping)) {}
+
+protected:
+    int_type underflow() override {
+        if (onFirstRead) {
+            std::function<void()> callback = std::move(onFirstRead);
+            onFirstRead = nullptr;
+            callback();
+            setg(input.data(), input.data(), input.data() + input.size());
+        }
+        return gptr() < egptr() ? traits_type::to_int_type(*gptr()) : traits_type::eof();
+    }
+
+private:
+    std::string input;
+    std::function<void()> onFirstRead;
+};
+
+TEST(TodoListTest, PromptsDoNotHoldTheLock) {
+    std::cout << "\nRunning PromptsDoNotHoldTheLock test...\n";
+
+    TodoList todoList("Prompts");
+    todoList.setConcurrentMode(true);
+    todoList.addActivity(Activity("Duplicate", false, 100));
+    todoList.addActivity(Activity("Duplicate", false, 200));
+    todoList.addActivity(Activity("Other", false, 300));
+    std::streambuf* console = std::cin.rdbuf();
+
+    // Pick the second duplicate and confirm; the list keeps changing while the user types
+    PromptInput choice("2\ny\n", [&todoList] { todoList.addActivity(Activity("Added meanwhile", false, 400)); });
+    std::cin.rdbuf(&choice);
+    EXPECT_NO_THROW(todoList.removeActivity("Duplicate"));
+    std::cin.rdbuf(console);
+    ASSERT_EQ(todoList.findActivitiesByName("Duplicate").size(), 1);
+    EXPECT_EQ(todoList.findActivitiesByName("Duplicate")[0].getDueDate(), 100);
+    EXPECT_EQ(todoList.getTotalActivities(), 3);
+
+    // The activity being confirmed is removed by someone else first
+    PromptInput confirmation("y\n", [&todoList] { todoList.removeActivity("Other", true); });
+    std::cin.rdbuf(&confirmation);
+    EXPECT_THROW(todoList.removeActivity("Other"), std::out_of_range);
+    std::cin.rdbuf(console);
+    EXPECT_EQ(todoList.getTotalActivities(), 2);
+
+    std::cout << "PromptsDoNotHoldTheLock test PASSED!\n";
+}
+
+TEST(TodoListTest, Snapshots) {
+    std::cout << "\nRunning Snapshots test...\n";
+
+    TodoList todoList("Versions");
+    std::vector<Activity> imported;
+    for (int i = 0; i < 2000; ++i) {
+        imported.emplace_back("Task " + std::to_string(i), i % 2 == 0, 1000 + (i * 37) % 500);
+    }
+    todoList.addActivities(imported);
+
+    std::shared_ptr<const ActivitySnapshot> first = todoList.snapshot();
+    const std::string firstText = todoList.toString();
+    EXPECT_EQ(first->toString(), firstText);
+    EXPECT_EQ(first->size(), 2000);
+    EXPECT_EQ(todoList.snapshot(), first); // Nothing changed: the published version is reused
+
+    // Edits after the snapshot do not show through it
+    todoList.removeActivity("Task 5", true);
+    todoList.editActivity("Task 1000", "Renamed", true, false, true, 1);
+    todoList.addActivity(Activity("Appended", false, 1200));
+    todoList.setName("Renamed list");
+    EXPECT_EQ(first->toString(), firstText);
+    EXPECT_EQ(first->getName(), "Versions");
+
+    std::shared_ptr<const ActivitySnapshot> second = todoList.snapshot();
+    EXPECT_GT(second->getVersion(), first->getVersion());
+    EXPECT_EQ(second->toString(), todoList.toString());
+    EXPECT_EQ(second->getActivities().size(), todoList.getTotalActivities());
+    EXPECT_TRUE(std::equal(second->begin(), second->end(), todoList.viewActivities().begin(),
+                           [](const Activity& a, const Activity& b) { return a.getId() == b.getId(); }));
+
+    // Only the chunks holding Task 5, Task 1000 and the appended activity were copied
+    size_t shared = 0;
+    for (size_t i = 0; i < first->getChunkCount(); ++i) {
+        shared += first->getChunk(i) == second->getChunk(i);
+    }
+    EXPECT_EQ(shared, first->getChunkCount() - 3);
+
+    // A completion keeps the due date order, which is shared as well
+    todoList.markActivityAsCompleted("Task 7");
+    EXPECT_EQ(todoList.snapshot()->getDueDateOrder(), second->getDueDateOrder());
+
+    // An add or a re-date only copies the leaves of the due date order it lands in
+    const std::string secondText = second->toString();
+    todoList.addActivity(Activity("Late add", false, 1250));
+    todoList.editActivity("Task 3", "", false, false, true, 1100);
+    std::shared_ptr<const ActivitySnapshot> third = todoList.snapshot();
+    const DueDateIndex& before = *second->getDueDateOrder();
+    const DueDateIndex& after = *third->getDueDateOrder();
+    size_t sharedLeaves = 0;
+    for (size_t i = 0; i < after.getLeafCount(); ++i) {
+        for (size_t j = 0; j < before.getLeafCount(); ++j) {
+            sharedLeaves += after.getLeaf(i) == before.getLeaf(j);
+        }
+    }
+    EXPECT_GT(before.getLeafCount(), 5);
+    EXPECT_GE(sharedLeaves + 4, after.getLeafCount()); // Re-dating touches two leaves, adding one, a split one more
+    EXPECT_EQ(second->toString(), secondText);
+    EXPECT_EQ(third->toString(), todoList.toString());
+
+    // Compaction renumbers every slot: nothing can be shared, but the content is the same
+    todoList.compact();
+    EXPECT_EQ(todoList.snapshot()->toString(), todoList.toString());
+
+    // A snapshot saves the same file as the list it was taken from
+    const std::string fromList = "snapshot_list.txt";
+    const std::string fromSnapshot = "snapshot_copy.txt";
+    todoList.saveToFile(fromList);
+    todoList.snapshot()->saveToFile(fromSnapshot);
+    std::ifstream a(fromList), b(fromSnapshot);
+    std::stringstream contentA, contentB;
+    contentA << a.rdbuf();
+    contentB << b.rdbuf();
+    EXPECT_EQ(contentA.str(), contentB.str());
+    std::remove(fromList.c_str());
+    std::remove(fromSnapshot.c_str());
+
+    // Reporting threads keep reading snapshots while a writer edits the list
+    todoList.setConcurrentMode(true);
+    std::atomic<bool> writerDone{false};
+    std::atomic<size_t> readerErrors{0};
+    std::thread reporter([&todoList, &writerDone, &readerErrors] {
+        uint64_t lastVersion = 0;
+        while (!writerDone) {
+            std::shared_ptr<const ActivitySnapshot> current = todoList.snapshot();
+            if (current->getVersion() < lastVersion) ++readerErrors;
+            lastVersion = current->getVersion();
+            const std::string text = current->toString();
+            if (static_cast<size_t>(std::count(text.begin(), text.end(), '\n')) != current->size() + 1) ++readerErrors;
+        }
+    });
+    for (int i = 0; i < 300; ++i) {
+        todoList.addActivity(Activity("Concurrent " + std::to_string(i), false, 1000 + i));
+        todoList.markActivityAsCompleted(std::to_string(1 + i * 3));
+        if (i % 4 == 0) todoList.removeActivity("Concurrent " + std::to_string(i), true);
+    }
+    writerDone = true;
+    reporter.join();
+    EXPECT_EQ(readerErrors, 0);
+    EXPECT_EQ(todoList.snapshot()->toString(), todoList.toString());
+
+    std::cout << "Snapshots test PASSED!\n";
+}
+
+TEST(ObserverDispatcherTest, MpscQueueKeepsProducerOrder) {
+    std::cout << "\nRunning MpscQueueKeepsProducerOrder test...\n";
+
+    MpscQueue<std::pair<int, int>> queue(16); // Small enough to be full most of the time
+    EXPECT_EQ(queue.capacity(), 16);
+    const int producers = 4;
+    const int perProducer = 2000;
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&queue, p] {
+            for (int i = 0; i < perProducer; ++i) {
+                std::pair<int, int> value(p, i);
+                while (!queue.tryPush(value)) std::this_thread::yield();
+            }
+        });
+    }
+
+    std::vector<int> next(producers, 0);
+    int received = 0;
+    bool ordered = true;
+    while (received < producers * perProducer) {
+        std::pair<int, int> value;
+        if (!queue.tryPop(value)) {
+            std::this_thread::yield();
+            continue;
+        }
+        ordered = ordered && value.second == next[value.first];
+        ++next[value.first];
+        ++received;
+    }
+    for (std::thread& thread : threads) thread.join();
+    EXPECT_TRUE(ordered);
+    std::pair<int, int> extra;
+    EXPECT_FALSE(queue.tryPop(extra));
+    EXPECT_EQ(queue.pushedCount(), static_cast<size_t>(producers * perProducer));
+
+    std::cout << "MpscQueueKeepsProducerOrder test PASSED!\n";
+}
+
+// Records the events it receives after a delay, to stand in for a slow display
+class SlowObserver : public Observer {
+public:
+    explicit SlowObserver(std::chrono::milliseconds observerDelay) : delay(observerDelay) {}
+    std::vector<ChangeEvent> events;
+    std::thread::id lastThread;
+
+    void update() override {}
+
+    void onChange(const ChangeEvent& event) override {
+        std::this_thread::sleep_for(delay);
+        lastThread = std::this_thread::get_id();
+        events.push_back(event);
+    }
+
+private:
+    std::chrono::milliseconds delay;
+};
+
+TEST(ObserverDispatcherTest, AsyncNotifications) {
+    std::cout << "\nRunning AsyncNotifications test...\n";
+
+    auto dispatcher = std::make_shared<ObserverDispatcher>(8);
+    TodoList todoList("Async");
+    SlowObserver slow(std::chrono::milliseconds(5));
+    todoList.addObserver(&slow);
+    todoList.setDispatcher(dispatcher);
+    EXPECT_EQ(todoList.getDispatcher(), dispatcher);
+
+    // The mutations do not wait for the 5 ms observer (beyond the 8 queued notifications)
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 4; ++i) {
+        todoList.addActivity(Activity("Task " + std::to_string(i), false, 1000 + i));
+    }
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(15));
+    for (int i = 4; i < 20; ++i) {
+        todoList.addActivity(Activity("Task " + std::to_string(i), false, 1000 + i)); // Waits for room when full
+    }
+    todoList.flushNotifications();
+    ASSERT_EQ(slow.events.size(), 20);
+    for (size_t i = 0; i < slow.events.size(); ++i) {
+        EXPECT_EQ(slow.events[i].type, ChangeType::Added);
+        EXPECT_EQ(slow.events[i].index, i);
+    }
+    EXPECT_NE(slow.lastThread, std::this_thread::get_id());
+
+    // Two lists updated from two threads share the dispatcher; each list's changes arrive in order
+    TodoList other("Other");
+    other.setDispatcher(dispatcher);
+    MockChangeObserver first, second;
+    todoList.addObserver(&first);
+    other.addObserver(&second);
+    std::thread writer([&other] {
+        for (int i = 0; i < 500; ++i) other.addActivity(Activity("Other " + std::to_string(i)));
+    });
+    todoList.removeObserver(&slow); // Returns once slow has everything queued for it
+    const size_t slowEvents = slow.events.size();
+    for (int i = 0; i < 500; ++i) todoList.markActivityAsCompleted(std::to_string(i % 20 + 1));
+    writer.join();
+    dispatcher->flush();
+    EXPECT_EQ(slow.events.size(), slowEvents);
+    ASSERT_EQ(second.events.size(), 500);
+    for (size_t i = 0; i < second.events.size(); ++i) {
+        EXPECT_EQ(second.events[i].index, i);
+    }
+    EXPECT_EQ(first.events.size(), 500);
+
+    // Back to synchronous calls
+    todoList.setDispatcher(nullptr);
+    todoList.addActivity(Activity("Sync"));
+    EXPECT_EQ(first.events.size(), 501);
+    other.removeObserver(&second);
+    todoList.removeObserver(&first);
+
+    std::cout << "AsyncNotifications test PASSED!\n";
+}
+
+// Observer that fails on every odd notification
+class FailingObserver : public Observer {
+public:
+    size_t calls = 0;
+
+    void update() override {
+        if (calls++ % 2 == 1) throw std::runtime_error("Observer failed");
+    }
+};
+
+TEST(ObserverDispatcherTest, ObserverExceptions) {
+    std::cout << "\nRunning ObserverExceptions test...\n";
+
+    auto dispatcher = std::make_shared<ObserverDispatcher>(4);
+    TodoList todoList("Failing");
+    FailingObserver failing;
+    MockChangeObserver healthy;
+    todoList.addObserver(&failing);
+    todoList.addObserver(&healthy);
+    todoList.setDispatcher(dispatcher);
+
+    // Failures do not stop the dispatcher thread: every notification is still delivered
+    for (int i = 0; i < 10; ++i) {
+        todoList.addActivity(Activity("Task " + std::to_string(i)));
+    }
+    EXPECT_THROW(todoList.flushNotifications(), std::runtime_error);
+    EXPECT_EQ(failing.calls, 10);
+    EXPECT_EQ(healthy.events.size(), 10);
+    EXPECT_EQ(dispatcher->getDeliveredCount(), 20);
+    EXPECT_NO_THROW(todoList.flushNotifications()); // Reported once
+
+    // removeObserver() only drains: the error stays for the next flushNotifications()
+    todoList.addActivity(Activity("Odd"));
+    todoList.addActivity(Activity("Even"));
+    EXPECT_NO_THROW(todoList.removeObserver(&failing));
+    EXPECT_THROW(todoList.flushNotifications(), std::runtime_error);
+    todoList.removeObserver(&healthy);
+
+    // An observer failing on one list is not reported to another list sharing the dispatcher, and
+    // destroying a display on that other list does not throw from its destructor
+    TodoList failingList("Failing");
+    TodoList otherList("Other");
+    failingList.setConcurrentMode(true);
+    otherList.setConcurrentMode(true);
+    failingList.setDispatcher(dispatcher);
+    otherList.setDispatcher(dispatcher);
+    FailingObserver alwaysFailing;
+    alwaysFailing.calls = 1;
+    failingList.addObserver(&alwaysFailing);
+    std::ostringstream output;
+    {
+        ConsoleDisplay display(otherList, DisplayMode::Incremental, std::chrono::milliseconds(0), output);
+        otherList.addActivity(Activity("Unrelated"));
+        failingList.addActivity(Activity("Boom"));
+        dispatcher->flush();
+    }
+    EXPECT_NO_THROW(otherList.flushNotifications());
+    EXPECT_THROW(failingList.flushNotifications(), std::runtime_error);
+    failingList.removeObserver(&alwaysFailing);
+
+    std::cout << "ObserverExceptions test PASSED!\n";
+}
+
+TEST(TodoListStoreTest, CreateFindRenameRemove) {
+    std::cout << "\nRunning CreateFindRenameRemove test...\n";
+
+    TodoListStore store(4);
+    std::shared_ptr<TodoList> work = store.create("Work");
+    store.create("Home");
+    EXPECT_THROW(store.create("Work"), std::invalid_argument);
+    EXPECT_THROW(store.create(""), std::invalid_argument);
+    EXPECT_EQ(store.size(), 2);
+    EXPECT_EQ(store.find("Work"), work);
+    EXPECT_EQ(store.find("Missing"), nullptr);
+    EXPECT_EQ(store.getNames(), (std::vector<std::string>{"Home", "Work"}));
+
+    // Renaming moves the handle only: the same list, now under (and called by) its new name
+    work->addActivity(Activity("Report", false, 1000));
+    MockChangeObserver observer;
+    work->addObserver(&observer);
+    store.rename("Work", "Office");
+    EXPECT_EQ(store.find("Office"), work);
+    EXPECT_FALSE(store.contains("Work"));
+    EXPECT_EQ(work->getName(), "Office");
+    EXPECT_EQ(work->getTotalActivities(), 1);
+    ASSERT_EQ(observer.events.size(), 1);
+    EXPECT_EQ(observer.events[0].type, ChangeType::Renamed);
+    EXPECT_THROW(store.rename("Office", "Home"), std::invalid_argument);
+    EXPECT_THROW(store.rename("Work", "Elsewhere"), std::out_of_range);
+    work->removeObserver(&observer);
+
+    EXPECT_TRUE(store.remove("Home"));
+    EXPECT_FALSE(store.remove("Home"));
+    EXPECT_EQ(store.size(), 1);
+
+    std::cout << "CreateFindRenameRemove test PASSED!\n";
+}
+
+TEST(TodoListStoreTest, LazyLoading) {
+    std::cout << "\nRunning LazyLoading test...\n";
+
+    const std::string filename = "store_lazy.bin";
+    TodoList saved("Saved");
+    saved.addActivity(Activity("Stored", true, 1000));
+    saved.saveToFile(filename, FileFormat::Binary);
+
+    TodoListStore store;
+    store.attach("Archive", filename);
+    store.attach("Broken", "store_missing_file.txt");
+    EXPECT_THROW(store.attach("Archive", filename), std::invalid_argument);
+    EXPECT_TRUE(store.contains("Archive"));
+    EXPECT_FALSE(store.isLoaded("Archive"));
+
+    // Renaming an unloaded list does not load it
+    store.rename("Archive", "Old");
+    EXPECT_FALSE(store.isLoaded("Old"));
+    std::shared_ptr<TodoList> old = store.find("Old");
+    ASSERT_NE(old, nullptr);
+    EXPECT_TRUE(store.isLoaded("Old"));
+    EXPECT_EQ(old->getName(), "Old");
+    EXPECT_EQ(old->getTotalActivities(), 1);
+    EXPECT_EQ(store.find("Old"), old); // Loaded once
+
+    EXPECT_THROW((void)store.find("Broken"), std::runtime_error);
+    EXPECT_FALSE(store.isLoaded("Broken"));
+
+    // Concurrent first accesses share one load, made without blocking the other lists of the shard
+    TodoListStore oneShard(1);
+    std::vector<Activity> many(20000, Activity("Stored", false, 1000));
+    saved.addActivities(many);
+    saved.saveToFile(filename, FileFormat::Binary);
+    oneShard.attach("Big", filename);
+    oneShard.attach("Broken", "store_missing_file.txt");
+    oneShard.create("Small");
+    std::vector<std::shared_ptr<TodoList>> found(4);
+    std::atomic<size_t> failures{0};
+    std::vector<std::thread> readers;
+    for (size_t t = 0; t < found.size(); ++t) {
+        readers.emplace_back([&oneShard, &found, &failures, t] {
+            found[t] = oneShard.find("Big");
+            try {
+                (void)oneShard.find("Broken");
+            } catch (const std::runtime_error&) {
+                ++failures;
+            }
+        });
+    }
+    while (!oneShard.isLoaded("Big")) {
+        EXPECT_NE(oneShard.find("Small"), nullptr);
+    }
+    for (std::thread& reader : readers) reader.join();
+    EXPECT_EQ(failures, found.size());
+    for (const auto& list : found) {
+        EXPECT_EQ(list, oneShard.find("Big"));
+    }
+    EXPECT_EQ(found[0]->getTotalActivities(), 20001);
+    oneShard.rename("Big", "Renamed"); // Never races with the load it could have interrupted
+    EXPECT_EQ(oneShard.find("Renamed")->getName(), "Renamed");
+    std::remove(filename.c_str());
+
+    std::cout << "LazyLoading test PASSED!\n";
+}
+
+TEST(TodoListStoreTest, ConcurrentAccess) {
+    std::cout << "\nRunning ConcurrentAccess test...\n";
+
+    TodoListStore store;
+    std::vector<std::thread> threads;
+    std::atomic<size_t> errors{0};
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&store, &errors, t] {
+            for (int i = 0; i < 250; ++i) {
+                const std::string name = "List " + std::to_string(t) + "-" + std::to_string(i);
+                store.create(name)->addActivity(Activity("Task"));
+                if (i % 2 == 0) store.rename(name, name + " renamed");
+                if (!store.find(i % 2 == 0 ? name + " renamed" : name)) ++errors;
+                if (i % 5 == 0 && !store.remove(i % 2 == 0 ? name + " renamed" : name)) ++errors;
+            }
+        });
+    }
+    for (std::thread& thread : threads) thread.join();
+    EXPECT_EQ(errors, 0);
+    EXPECT_EQ(store.size(), 800);
+    EXPECT_EQ(store.getNames().size(), 800);
+
+    std::cout << "ConcurrentAccess test PASSED!\n";
+}
+
+TEST(TodoListStoreTest, ConcurrentPaging) {
+    std::cout << "\nRunning ConcurrentPaging test...\n";
+
+    // Room for a few lists only, so sweeps keep saving lists while other threads rename, remove and reload them
+    const std::string directory = "store_concurrent_paging";
+    {
+        TodoListStore store(4);
+        store.setMemoryBudget(TodoList("Sizing").getMemoryUsage() * 8, directory);
+        std::vector<std::thread> threads;
+        std::atomic<size_t> errors{0};
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&store, &errors, t] {
+                for (int i = 0; i < 100; ++i) {
+                    const std::string name = "List " + std::to_string(t) + "-" + std::to_string(i);
+                    store.create(name)->addActivity(Activity("Task"));
+                    const std::string current = i % 2 == 0 ? name + " renamed" : name;
+                    if (i % 2 == 0) store.rename(name, current);
+                    std::shared_ptr<TodoList> list = store.find(current);
+                    if (!list || list->getTotalActivities() != 1) ++errors;
+                    if (i % 5 == 0 && !store.remove(current)) ++errors;
+                }
+            });
+        }
+        for (std::thread& thread : threads) thread.join();
+        EXPECT_EQ(errors, 0);
+        EXPECT_EQ(store.size(), 320);
+        for (const std::string& name : store.getNames()) {
+            std::shared_ptr<TodoList> list = store.find(name);
+            ASSERT_NE(list, nullptr);
+            EXPECT_EQ(list->getName(), name);
+            EXPECT_EQ(list->getTotalActivities(), 1);
+        }
+        EXPECT_LT(store.getLoadedCount(), 320);
+    }
+    EXPECT_TRUE(std::filesystem::is_empty(directory));
+    std::filesystem::remove_all(directory);
+
+    std::cout << "ConcurrentPaging test PASSED!\n";
+}
+
+TEST(TodoListStoreTest, MemoryBudgetEviction) {
+    std::cout << "\nRunning MemoryBudgetEviction test...\n";
+
+    const std::string directory = "store_paging";
+    std::map<std::string, std::string> expected;
+    {
+        TodoListStore store(4);
+        size_t perList = 0;
+        for (int l = 0; l < 20; ++l) {
+            const std::string name = "List " + std::to_string(l);
+            std::shared_ptr<TodoList> list = store.create(name);
+            for (int i = 0; i < 200; ++i) {
+                list->addActivity(Activity(name + " task " + std::to_string(i), i % 3 == 0, 1000 + i));
+            }
+            expected[name] = list->toString();
+            perList = list->getMemoryUsage();
+        }
+        EXPECT_EQ(store.getLoadedCount(), 20);
+
+        // Room for about five lists; one handle is kept, so that list must stay loaded
+        std::shared_ptr<TodoList> held = store.find("List 7");
+        store.setMemoryBudget(perList * 5, directory);
+        EXPECT_LE(store.getResidentBytes(), perList * 5);
+        EXPECT_LE(store.getLoadedCount(), 5);
+        EXPECT_TRUE(store.isLoaded("List 7"));
+        held.reset();
+
+        // Every list comes back with its content, whether it was evicted or not
+        for (const auto& [name, text] : expected) {
+            std::shared_ptr<TodoList> list = store.find(name);
+            ASSERT_NE(list, nullptr);
+            EXPECT_EQ(list->toString(), text);
+        }
+        EXPECT_LE(store.getLoadedCount(), 6);
+
+        // A list grown through its handle is re-estimated by the next find, which then evicts the others
+        std::shared_ptr<TodoList> growing = store.find("List 0");
+        for (int i = 0; i < 2000; ++i) {
+            growing->addActivity(Activity("Grown task " + std::to_string(i), false, 5000 + i));
+        }
+        EXPECT_EQ(store.find("List 0"), growing);
+        EXPECT_GE(store.getResidentBytes(), growing->getMemoryUsage());
+        EXPECT_EQ(store.getLoadedCount(), 1);
+        expected["List 0"] = growing->toString();
+        growing.reset();
+
+        // Changes made to a reloaded list are saved when it is evicted again
+        store.find("List 3")->addActivity(Activity("Added after reload", false, 1));
+        expected["List 3"] = store.find("List 3")->toString();
+        store.rename("List 3", "List 3 renamed");
+        store.setMemoryBudget(1, directory); // Evicts everything not in use
+        EXPECT_EQ(store.getLoadedCount(), 0);
+        EXPECT_EQ(store.find("List 3 renamed")->toString(),
+                  "--- Todo List: List 3 renamed ---" + expected["List 3"].substr(expected["List 3"].find('\n')));
+        EXPECT_TRUE(store.remove("List 4"));
+        store.setMemoryBudget(0, directory);
+    }
+    // The store removes its paging files
+    EXPECT_TRUE(std::filesystem::is_empty(directory));
+    std::filesystem::remove_all(directory);
+
+    // An attached list is written back to its own file, in its own format
+    const std::string filename = "store_attached.txt";
+    TodoList original("Attached");
+    original.addActivity(Activity("On disk", false, 1000));
+    original.saveToFile(filename);
+    {
+        TodoListStore store;
+        store.attach("Attached", filename);
+        store.find("Attached")->addActivity(Activity("In memory", false, 2000));
+        store.setMemoryBudget(1, directory);
+        EXPECT_FALSE(store.isLoaded("Attached"));
+        EXPECT_EQ(store.find("Attached")->getTotalActivities(), 2);
+    }
+    std::ifstream file(filename, std::ios::in | std::ios::binary);
+    EXPECT_EQ(detectFileFormat(file), FileFormat::Text);
+    file.close();
+    std::remove(filename.c_str());
+    std::filesystem::remove_all(directory);
+
+    std::cout << "MemoryBudgetEviction test PASSED!\n";
+}
@@ -5,6 +5,11 @@
 #include <algorithm>
 #include <iomanip>
 #include <utility>
+#include <limits>
+#include <iterator>
+#include <thread>
+#include <cassert>
+#include <exception>
 
 // Default constructor
 TodoList::TodoList() : name("UnnamedList") {}
@@ -14,49 +19,259 @@ TodoList::TodoList(std::string  listName) : name(std::move(listName)) {}
 
 // Get the name of the list
 std::string TodoList::getName() const {
+    auto lock = readLock();
     return name;
 }
 
 // Set a new name for the list
 void TodoList::setName(const std::string& newName) {
+    MutationScope scope(*this);
+    ChangeEvent event;
+    event.type = ChangeType::Renamed;
+    event.oldName = name;
+    event.newName = newName;
+
     name = newName;
-    notifyObservers();
+    noteChanged();
+    if (journalSlot.journal) {
+        journalSlot.journal->appendSetName(name);
+        checkpointIfNeeded();
+    }
+    scope.notify(event);
 }
 
-// Getter for the activities list
+// Getter for the activities list (a copy; see viewActivities() for the zero-copy variant)
 std::vector<Activity> TodoList::getActivities() const {
-    return activities;
+    auto lock = readLock();
+    if (liveSlots.deadCount() == 0) {
+        return activities;
+    }
+    ActivitySpan live = viewActivities();
+    return std::vector<Activity>(live.begin(), live.end());
+}
+
+// Views share the storage and the indexes instead of copying activities
+ActivitySpan TodoList::viewActivities() const {
+    return {activities.data(), activities.data() + activities.size(), tombstones()};
+}
+
+ActivityPositionsView TodoList::viewActivitiesByName(const std::string& name) const {
+    const std::vector<size_t>& slots = slotsByDescription(name);
+    return {activities.data(), slots.data(), slots.data() + slots.size(), tombstones()};
+}
+
+ActivityDueDateView TodoList::viewActivitiesDueBetween(std::time_t from, std::time_t to) const {
+    if (from > to) return {};
+    auto first = dueDateOrder.lowerBound(from);
+    auto last = to == std::numeric_limits<std::time_t>::max() ? dueDateOrder.end() : dueDateOrder.lowerBound(to + 1);
+    return {activities.data(), first, last, tombstones()};
 }
 
 // Get total number of activities
 size_t TodoList::getTotalActivities() const {
-    return activities.size();
+    auto lock = readLock();
+    return liveSlots.liveCount();
 }
 
+// Debug builds recheck the cached counters on every read (define TODOLIST_NO_COUNTER_CHECKS to skip it)
+#if !defined(NDEBUG) && !defined(TODOLIST_NO_COUNTER_CHECKS)
+#define CHECK_COMPLETED_COUNT() assert(completedCountMatches())
+#define CHECK_OVERDUE_COUNT() assert(overdueCountMatches())
+#else
+#define CHECK_COMPLETED_COUNT() ((void)0)
+#define CHECK_OVERDUE_COUNT() ((void)0)
+#endif
+
 // Get number of pending activities
 size_t TodoList::getPendingActivities() const {
-    return std::count_if(activities.begin(), activities.end(), [](const Activity& a) {
-        return !a.isCompleted();
-    });
+    auto lock = readLock();
+    CHECK_COMPLETED_COUNT();
+    return liveSlots.liveCount() - completedCount;
+}
+
+size_t TodoList::getCompletedActivities() const {
+    auto lock = readLock();
+    CHECK_COMPLETED_COUNT();
+    return completedCount;
+}
+
+// Get number of overdue activities, moving the cached watermark to now.
+// Concurrent readers share the data lock, so the watermark has a mutex of its own.
+size_t TodoList::getOverdueActivities(std::time_t now) const {
+    auto lock = readLock();
+    std::unique_lock<std::mutex> cacheLock(locks.overdueCache, std::defer_lock);
+    if (locks.enabled) cacheLock.lock();
+
+    if (now < overdueAsOf || overdueAsOf == std::numeric_limits<std::time_t>::min()) {
+        // Clock moved backwards (or first query): one scan over the packed columns
+        overdueCount = columns.countOverdue(now);
+    } else if (now > overdueAsOf) {
+        // Only the activities due in [overdueAsOf, now) can have become overdue
+        for (auto it = dueDateOrder.lowerBound(overdueAsOf); it != dueDateOrder.end() && it.dueDate() < now; ++it) {
+            overdueCount += !columns.isCompleted(*it);
+        }
+    }
+    overdueAsOf = now;
+    CHECK_OVERDUE_COUNT();
+    return overdueCount;
+}
+
+// Per slot: the activity, its due date order entry, its columns and the hash index nodes pointing at it
+size_t TodoList::getMemoryUsage() const {
+    constexpr size_t INDEX_BYTES_PER_SLOT = 2 * sizeof(size_t) + 64;
+    auto lock = readLock();
+    return sizeof(TodoList) + activities.capacity() * sizeof(Activity) + dueDateOrder.getMemoryUsage() +
+           activities.size() * (sizeof(std::time_t) + INDEX_BYTES_PER_SLOT) + descriptionBytes;
+}
+
+uint64_t TodoList::getVersion() const {
+    return snapshots.version.load(std::memory_order_acquire);
+}
+
+bool TodoList::countersAreConsistent() const {
+    auto lock = readLock();
+    std::unique_lock<std::mutex> cacheLock(locks.overdueCache, std::defer_lock);
+    if (locks.enabled) cacheLock.lock();
+    return completedCountMatches() && overdueCountMatches();
+}
+
+bool TodoList::completedCountMatches() const {
+    return columns.countCompleted() == completedCount;
+}
+
+bool TodoList::overdueCountMatches() const {
+    return overdueAsOf == std::numeric_limits<std::time_t>::min() || columns.countOverdue(overdueAsOf) == overdueCount;
+}
+
+void TodoList::setConcurrentMode(bool enabled) {
+    locks.enabled = enabled;
+}
+
+bool TodoList::isConcurrentMode() const {
+    return locks.enabled;
+}
+
+// Readers only pass through the turnstile when a writer is queued, so the common path is one atomic load
+std::shared_lock<std::shared_mutex> TodoList::readLock() const {
+    if (!locks.enabled) return {};
+    if (locks.waitingWriters.load(std::memory_order_acquire) > 0) {
+        std::lock_guard<std::mutex> turn(locks.writerTurn);
+    }
+    return std::shared_lock<std::shared_mutex>(locks.data);
+}
+
+std::unique_lock<std::shared_mutex> TodoList::writeLock() {
+    if (!locks.enabled) return {};
+    locks.waitingWriters.fetch_add(1, std::memory_order_acq_rel);
+    std::lock_guard<std::mutex> turn(locks.writerTurn);
+    std::unique_lock<std::shared_mutex> lock(locks.data);
+    locks.waitingWriters.fetch_sub(1, std::memory_order_acq_rel);
+    return lock;
+}
+
+const LiveSlots* TodoList::tombstones() const {
+    return liveSlots.deadCount() > 0 ? &liveSlots : nullptr;
+}
+
+size_t TodoList::slotAt(size_t position) const {
+    return liveSlots.deadCount() > 0 ? liveSlots.select(position) : position;
+}
+
+size_t TodoList::positionOf(size_t slot) const {
+    return liveSlots.deadCount() > 0 ? liveSlots.rank(slot) : slot;
+}
+
+size_t TodoList::slotById(ActivityId id) const {
+    auto it = idIndex.find(id);
+    return it != idIndex.end() ? it->second : std::string::npos;
+}
+
+void TodoList::assignId(Activity& activity) {
+    if (activity.getId() == 0 || idIndex.count(activity.getId()) != 0) {
+        activity.setId(nextId++);
+    } else {
+        nextId = std::max(nextId, activity.getId() + 1);
+    }
+}
+
+const Activity* TodoList::findActivityById(ActivityId id) const {
+    const size_t index = slotById(id);
+    return index != std::string::npos ? &activities[index] : nullptr;
+}
+
+void TodoList::countActivityAt(size_t index) {
+    const bool completed = columns.isCompleted(index);
+    completedCount += completed;
+    overdueCount += !completed && columns.getDueDate(index) < overdueAsOf;
+}
+
+void TodoList::uncountActivityAt(size_t index) {
+    const bool completed = columns.isCompleted(index);
+    completedCount -= completed;
+    overdueCount -= !completed && columns.getDueDate(index) < overdueAsOf;
 }
 
 // Finds all activities that match the given name
 std::vector<Activity> TodoList::findActivitiesByName(const std::string& name) const {
-    std::vector<Activity> result;
-    for (const auto& activity : activities) {
-        if (activity.getDescription() == name) {
-            result.push_back(activity);
-        }
+    auto lock = readLock();
+    ActivityPositionsView matches = viewActivitiesByName(name);
+    return std::vector<Activity>(matches.begin(), matches.end());
+}
+
+// Looks up the description index; the empty vector is shared by every miss
+const std::vector<size_t>& TodoList::slotsByDescription(const std::string& description) const {
+    static const std::vector<size_t> noPositions;
+    auto it = descriptionIndex.find(description);
+    return it != descriptionIndex.end() ? it->second : noPositions;
+}
+
+// Rebuilds every index with one pass over the activities (plus the due date sort); all slots become live
+void TodoList::rebuildIndexes() {
+    noteAllChanged();
+    liveSlots.assign(activities.size());
+    columns.assign(activities);
+    descriptionIndex.clear();
+    idIndex.clear();
+    idIndex.reserve(activities.size());
+    nextId = 1;
+    descriptionBytes = 0;
+    for (const Activity& activity : activities) {
+        nextId = std::max(nextId, activity.getId() + 1);
+        descriptionBytes += activity.getDescription().size();
     }
-    return result;
+    std::vector<DueDateIndex::Entry> order(activities.size());
+    for (size_t i = 0; i < activities.size(); ++i) {
+        assignId(activities[i]); // Files without ids (or with duplicates) get fresh ones
+        idIndex.emplace(activities[i].getId(), i);
+        descriptionIndex[activities[i].getDescription()].push_back(i);
+        order[i] = {activities[i].getDueDate(), i};
+    }
+    std::sort(order.begin(), order.end());
+    dueDateOrder.assign(order);
+    completedCount = columns.countCompleted();
+    overdueAsOf = std::numeric_limits<std::time_t>::min(); // The next overdue query rescans
+    overdueCount = 0;
 }
 
-// Finds all activities with the same due date
+// Finds all activities with the same due date (the range query takes the lock)
 std::vector<Activity> TodoList::findActivitiesByDueDate(std::time_t dueDate) const {
+    return findActivitiesDueBetween(dueDate, dueDate);
+}
+
+// Finds all activities due in [from, to] with two binary searches over the due date index
+std::vector<Activity> TodoList::findActivitiesDueBetween(std::time_t from, std::time_t to) const {
+    auto lock = readLock();
+    ActivityDueDateView matches = viewActivitiesDueBetween(from, to);
+    return std::vector<Activity>(matches.begin(), matches.end());
+}
+
+// Walks the due date index from the given date, skipping completed and removed activities
+std::vector<Activity> TodoList::nextDue(size_t k, std::time_t from) const {
+    auto lock = readLock();
     std::vector<Activity> result;
-    for (const auto& activity : activities) {
-        if (activity.getDueDate() == dueDate) {
-            result.push_back(activity);
+    for (auto it = dueDateOrder.lowerBound(from); it != dueDateOrder.end() && result.size() < k; ++it) {
+        if (liveSlots.isLive(*it) && !activities[*it].isCompleted()) {
+            result.push_back(activities[*it]);
         }
     }
     return result;
@@ -64,88 +279,378 @@ std::vector<Activity> TodoList::findActivitiesByDueDate(std::time_t dueDate) con
 
 // Adds an observer to the list (if not already present)
 void TodoList::addObserver(Observer* observer) {
+    auto lock = writeLock();
     if (std::find(observers.begin(), observers.end(), observer) == observers.end()) {
         observers.push_back(observer);
     }
 }
 
-// Removes an observer from the list
+// Removes an observer from the list; with a dispatcher, waits until it has received what was already queued for it.
+// Observer errors are left for the next flushNotifications(): this runs from destructors, so it must not throw.
 void TodoList::removeObserver(Observer* observer) {
-    observers.erase(std::remove(observers.begin(), observers.end(), observer), observers.end());
+    {
+        auto lock = writeLock();
+        observers.erase(std::remove(observers.begin(), observers.end(), observer), observers.end());
+    }
+    if (auto async = std::atomic_load(&dispatcher)) {
+        async->flush();
+    }
+}
+
+// Observers are called on a copy (taken under the read lock in concurrent mode),
+// so they may read the list or (un)register from their callbacks
+std::vector<Observer*> TodoList::observersToNotify() const {
+    auto lock = readLock();
+    return observers;
 }
 
 // Notifies all observers when a change occurs
 void TodoList::notifyObservers() const {
-    for (Observer* observer : observers) {
+    if (auto async = std::atomic_load(&dispatcher)) {
+        for (Observer* observer : observersToNotify()) {
+            async->post(observer, nullptr, observerErrors);
+        }
+        return;
+    }
+    for (Observer* observer : observersToNotify()) {
         observer->update(); // Calls update() on each observer
     }
 }
 
-// Adds a new activity and notifies observers
-void TodoList::addActivity(const Activity& activity) {
-    activities.push_back(activity);
-    notifyObservers(); // Notify observers when a new activity is added
+// Notifies all observers with the change; observers without onChange() get update()
+void TodoList::notifyObservers(const ChangeEvent& event) const {
+    if (auto async = std::atomic_load(&dispatcher)) {
+        auto shared = std::make_shared<const ChangeEvent>(event); // One copy for all observers
+        for (Observer* observer : observersToNotify()) {
+            async->post(observer, shared, observerErrors);
+        }
+        return;
+    }
+    for (Observer* observer : observersToNotify()) {
+        observer->onChange(event);
+    }
 }
 
-void TodoList::removeActivity(const std::string& identifier, bool skipConfirmation) {
-    if (identifier.empty()) {
-        throw std::invalid_argument("Invalid input: identifier is empty.");
+void TodoList::setDispatcher(std::shared_ptr<ObserverDispatcher> newDispatcher) {
+    std::shared_ptr<ObserverDispatcher> previous = std::atomic_exchange(&dispatcher, std::move(newDispatcher));
+    if (previous) {
+        previous->flush(); // Nothing queued on the old dispatcher may arrive after the new notifications
     }
+}
 
-    if (bool isNumber = std::all_of(identifier.begin(), identifier.end(), ::isdigit)) {
-        size_t index = std::stoul(identifier);
-        if (index == 0 || index > activities.size()) {
-            throw std::out_of_range("Activity index is out of range!");
+std::shared_ptr<ObserverDispatcher> TodoList::getDispatcher() const {
+    return std::atomic_load(&dispatcher);
+}
+
+void TodoList::flushNotifications() const {
+    if (auto async = std::atomic_load(&dispatcher)) {
+        async->flush();
+    }
+    if (std::exception_ptr error = observerErrors->take()) {
+        std::rethrow_exception(error);
+    }
+}
+
+// Appends an activity (assigning its id) and records it in the journal
+void TodoList::appendActivity(Activity activity) {
+    activities.push_back(std::move(activity));
+    const Activity& added = activities.back();
+    liveSlots.pushBack();
+    noteSlotChanged(activities.size() - 1);
+    assignId(activities.back());
+    idIndex.emplace(added.getId(), activities.size() - 1);
+    columns.pushBack(added);
+    descriptionIndex[added.getDescription()].push_back(activities.size() - 1);
+    descriptionBytes += added.getDescription().size();
+    if (!dueDateOrderDeferred) {
+        dueDateOrder.insert(added.getDueDate(), activities.size() - 1);
+        noteOrderChanged();
+    }
+    countActivityAt(activities.size() - 1);
+    if (journalSlot.journal) {
+        journalSlot.journal->appendAdd(activities.back());
+    }
+}
+
+// Leaves a tombstone in the activity's slot and records the removal in the journal.
+// Nothing is shifted: the due date index keeps a stale entry, dropped at the next compaction.
+void TodoList::eraseActivityAt(size_t index) {
+    auto entry = descriptionIndex.find(activities[index].getDescription());
+    std::vector<size_t>& slots = entry->second;
+    slots.erase(std::lower_bound(slots.begin(), slots.end(), index));
+    if (slots.empty()) {
+        descriptionIndex.erase(entry);
+    }
+    tombstoneActivityAt(index);
+}
+
+void TodoList::tombstoneActivityAt(size_t index) {
+    const size_t position = positionOf(index);
+    uncountActivityAt(index);
+    idIndex.erase(activities[index].getId());
+    liveSlots.kill(index);
+    noteSlotChanged(index);
+    columns.retire(index);
+
+    if (journalSlot.journal) {
+        journalSlot.journal->appendRemove(position);
+    }
+}
+
+// Once tombstones outnumber live activities, the storage and indexes are rebuilt without them
+void TodoList::compactIfNeeded() {
+    if (liveSlots.deadCount() >= MIN_TOMBSTONES_TO_COMPACT && liveSlots.deadCount() > liveSlots.liveCount()) {
+        compactSlots();
+    }
+}
+
+void TodoList::compact() {
+    auto lock = writeLock();
+    compactSlots();
+}
+
+// Moves the live activities down over the tombstones (keeping their order) and renumbers every index
+void TodoList::compactSlots() {
+    if (liveSlots.deadCount() == 0) return;
+    noteAllChanged();
+
+    std::vector<size_t> newSlots(activities.size(), 0);
+    size_t live = 0;
+    for (size_t slot = 0; slot < activities.size(); ++slot) {
+        if (!liveSlots.isLive(slot)) continue;
+        newSlots[slot] = live;
+        if (live != slot) {
+            activities[live] = std::move(activities[slot]);
         }
-        index--;
-
-        if (!skipConfirmation) {
-            std::cout << "Are you sure you want to delete '"
-                      << activities[index].getDescription()
-                      << "'? (y/n): ";
-            char confirm;
-            std::cin >> confirm;
-            if (confirm != 'y' && confirm != 'Y') {
-                std::cout << "Deletion canceled.\n";
-                return;
-            }
+        ++live;
+    }
+    activities.erase(activities.begin() + static_cast<std::ptrdiff_t>(live), activities.end());
+    descriptionBytes = 0;
+    for (const Activity& activity : activities) {
+        descriptionBytes += activity.getDescription().size();
+    }
+
+    std::vector<DueDateIndex::Entry> order;
+    order.reserve(live);
+    for (auto it = dueDateOrder.begin(); it != dueDateOrder.end(); ++it) {
+        if (liveSlots.isLive(*it)) order.emplace_back(it.dueDate(), newSlots[*it]);
+    }
+    dueDateOrder.assign(order);
+    for (auto& [description, slots] : descriptionIndex) {
+        for (size_t& slot : slots) slot = newSlots[slot];
+    }
+    for (auto& [id, slot] : idIndex) slot = newSlots[slot];
+
+    columns.assign(activities);
+    liveSlots.assign(activities.size());
+}
+
+// Changes the completion status in a slot and records it in the journal
+void TodoList::setActivityCompletedAt(size_t index, bool completed) {
+    uncountActivityAt(index);
+    noteSlotChanged(index);
+    activities[index].setCompleted(completed);
+    columns.setCompleted(index, completed);
+    countActivityAt(index);
+    if (journalSlot.journal) {
+        journalSlot.journal->appendSetCompleted(positionOf(index), completed);
+    }
+}
+
+// Applies an edit in a slot and records it in the journal
+void TodoList::updateActivityAt(size_t index, const std::string& newDescription, bool changeCompletionStatus, bool newCompleted, bool changeDueDate, std::time_t newDueDate) {
+    Activity& activity = activities[index];
+    uncountActivityAt(index);
+    noteSlotChanged(index);
+
+    if (!newDescription.empty() && newDescription != activity.getDescription()) {
+        auto entry = descriptionIndex.find(activity.getDescription());
+        std::vector<size_t>& oldSlots = entry->second;
+        oldSlots.erase(std::lower_bound(oldSlots.begin(), oldSlots.end(), index));
+        if (oldSlots.empty()) {
+            descriptionIndex.erase(entry);
         }
 
-        activities.erase(activities.begin() + index);
-        notifyObservers();
-        return;
+        std::vector<size_t>& newSlots = descriptionIndex[newDescription];
+        newSlots.insert(std::lower_bound(newSlots.begin(), newSlots.end(), index), index);
+
+        descriptionBytes += newDescription.size() - activity.getDescription().size();
+        activity.setDescription(newDescription);
     }
 
-    // Search by name
-    std::vector<size_t> matchingIndexes;
-    for (size_t i = 0; i < activities.size(); ++i) {
-        if (activities[i].getDescription() == identifier) {
-            matchingIndexes.push_back(i);
+    if (changeCompletionStatus) {
+        activity.setCompleted(newCompleted);
+        columns.setCompleted(index, newCompleted);
+    }
+
+    if (changeDueDate && newDueDate != activity.getDueDate()) {
+        dueDateOrder.erase(activity.getDueDate(), index);
+        activity.setDueDate(newDueDate);
+        columns.setDueDate(index, newDueDate);
+        dueDateOrder.insert(newDueDate, index);
+        noteOrderChanged();
+    }
+    countActivityAt(index);
+
+    if (journalSlot.journal) {
+        uint8_t flags = (newDescription.empty() ? 0 : JOURNAL_EDIT_DESCRIPTION) |
+                        (changeCompletionStatus ? JOURNAL_EDIT_COMPLETED : 0) |
+                        (changeDueDate ? JOURNAL_EDIT_DUE_DATE : 0);
+        journalSlot.journal->appendEdit(positionOf(index), flags, newDescription, newCompleted, newDueDate);
+    }
+}
+
+void TodoList::reserveActivities(size_t additional) {
+    const size_t total = activities.size() + additional;
+    activities.reserve(total);
+    liveSlots.reserve(total);
+    columns.reserve(total);
+    idIndex.reserve(total);
+}
+
+// Few new slots are inserted one by one; past a sixteenth of the index, one sort and a linear merge are cheaper
+void TodoList::finishBulkAdd(size_t firstSlot, MutationScope& scope) {
+    dueDateOrderDeferred = false;
+    const size_t added = activities.size() - firstSlot;
+    if (added > 0 && added < dueDateOrder.size() / 16) {
+        for (size_t slot = firstSlot; slot < activities.size(); ++slot) {
+            dueDateOrder.insert(activities[slot].getDueDate(), slot);
         }
+    } else if (added > 0) {
+        std::vector<DueDateIndex::Entry> entries(added);
+        for (size_t i = 0; i < added; ++i) {
+            entries[i] = {activities[firstSlot + i].getDueDate(), firstSlot + i};
+        }
+        std::sort(entries.begin(), entries.end());
+        dueDateOrder.merge(entries);
+    }
+    noteOrderChanged();
+    if (activities.size() > firstSlot) {
+        checkpointIfNeeded();
+        scope.notify(ChangeEvent{});
     }
+}
 
-    if (matchingIndexes.empty()) {
-        throw std::out_of_range("No activity found with name '" + identifier + "'!");
+// Drops the removed slots from the description index in one sweep
+void TodoList::finishBulkRemoval(size_t removed, MutationScope& scope) {
+    if (removed == 0) return;
+    for (auto it = descriptionIndex.begin(); it != descriptionIndex.end();) {
+        std::vector<size_t>& slots = it->second;
+        slots.erase(std::remove_if(slots.begin(), slots.end(), [this](size_t slot) { return !liveSlots.isLive(slot); }),
+                    slots.end());
+        it = slots.empty() ? descriptionIndex.erase(it) : std::next(it);
     }
+    compactIfNeeded();
+    checkpointIfNeeded();
+    scope.notify(ChangeEvent{});
+}
+
+void TodoList::finishBulkEdit(size_t edited, MutationScope& scope) {
+    if (edited > 0) {
+        checkpointIfNeeded();
+        scope.notify(ChangeEvent{});
+    }
+}
 
-    size_t indexToRemove = matchingIndexes[0];
+TodoList::MutationScope::MutationScope(TodoList& todoList) : list(todoList), lock(todoList.writeLock()) {}
 
-    if (matchingIndexes.size() > 1) {
-        std::cout << "Multiple activities found with name '" << identifier << "'. Choose which one to remove:\n";
-        for (size_t i = 0; i < matchingIndexes.size(); ++i) {
-            std::cout << i + 1 << ". " << activities[matchingIndexes[i]].getDescription() << "\n";
+// Notifies observers now, or once at the end of the current batch. The journal records of the mutation are
+// synced first (JournalSync::Mutation), still under the lock; observers hear of the change even if that fails.
+void TodoList::MutationScope::notify(const ChangeEvent& event) {
+    if (list.batchDepth > 0) {
+        list.batchChanged = true;
+        return;
+    }
+    std::exception_ptr syncError;
+    if (list.journalSlot.journal) {
+        try {
+            list.journalSlot.journal->sync();
+        } catch (...) {
+            syncError = std::current_exception();
         }
-        size_t choice;
-        std::cout << "Enter the number: ";
-        std::cin >> choice;
-        if (choice == 0 || choice > matchingIndexes.size()) {
-            throw std::invalid_argument("Invalid choice. Operation canceled.");
+    }
+    deliver(event);
+    if (syncError) std::rethrow_exception(syncError);
+}
+
+void TodoList::MutationScope::deliver(const ChangeEvent& event) {
+    if (lock.owns_lock()) {
+        lock.unlock();
+    }
+    list.notifyObservers(event);
+}
+
+TodoList::Batch::Batch(TodoList& todoList) : list(todoList) {
+    auto lock = list.writeLock();
+    ++list.batchDepth;
+}
+
+// Ending the outermost batch emits the single coalesced notification. A failed journal sync cannot be thrown
+// from here: the records stay pending, and the next mutation syncs them (or reports the error).
+TodoList::Batch::~Batch() {
+    MutationScope scope(list);
+    if (--list.batchDepth == 0 && list.batchChanged) {
+        list.batchChanged = false;
+        if (list.journalSlot.journal) {
+            try {
+                list.journalSlot.journal->sync();
+            } catch (const std::exception&) {
+            }
         }
-        indexToRemove = matchingIndexes[choice - 1];
+        scope.deliver(ChangeEvent{});
     }
+}
+
+// Adds a new activity and notifies observers
+ActivityId TodoList::addActivity(const Activity& activity) {
+    MutationScope scope(*this);
+    appendActivity(activity);
+    checkpointIfNeeded();
+
+    ChangeEvent event;
+    event.type = ChangeType::Added;
+    event.index = liveSlots.liveCount() - 1;
+    event.newValue = activities.back();
+    const ActivityId id = activities.back().getId();
+    scope.notify(event); // Notify observers when a new activity is added
+    return id;
+}
+
+// Removes the activity in a slot; the caller reports the returned event to observers
+ChangeEvent TodoList::removeActivityAt(size_t index) {
+    ChangeEvent event;
+    event.type = ChangeType::Removed;
+    event.index = positionOf(index);
+    event.oldValue = activities[index];
+
+    eraseActivityAt(index);
+    compactIfNeeded();
+    checkpointIfNeeded();
+    return event;
+}
+
+// Marks the activity in a slot as completed; the caller reports the returned event to observers
+ChangeEvent TodoList::completeActivityAt(size_t index) {
+    ChangeEvent event;
+    event.type = ChangeType::Completed;
+    event.index = positionOf(index);
+    event.oldValue = activities[index];
+
+    setActivityCompletedAt(index, true);
+    checkpointIfNeeded();
+
+    event.newValue = activities[index];
+    return event;
+}
+
+// Picks the activity under the read lock, asks the user with no lock held (in concurrent mode a prompt
+// would otherwise stall every reader and writer), then removes it by id if it still exists
+void TodoList::removeActivity(const std::string& identifier, bool skipConfirmation) {
+    std::string description;
+    const ActivityId id = chooseActivity(identifier, "remove", description);
 
     if (!skipConfirmation) {
-        std::cout << "Are you sure you want to delete '" << activities[indexToRemove].getDescription() << "'? (y/n): ";
+        std::cout << "Are you sure you want to delete '" << description << "'? (y/n): ";
         char confirm;
         std::cin >> confirm;
         if (confirm != 'y' && confirm != 'Y') {
@@ -154,147 +659,328 @@ void TodoList::removeActivity(const std::string& identifier, bool skipConfirmati
         }
     }
 
-    activities.erase(activities.begin() + indexToRemove);
-    notifyObservers();
+    removeActivity(id);
 }
 
-void TodoList::markActivityAsCompleted(const std::string& identifier) {
+// Resolves a 1-based position or a name under the read lock; duplicate names are offered to the user afterwards
+ActivityId TodoList::chooseActivity(const std::string& identifier, const std::string& action, std::string& description) const {
     if (identifier.empty()) {
         throw std::invalid_argument("Invalid input: identifier is empty.");
     }
 
-    if (bool isNumber = std::all_of(identifier.begin(), identifier.end(), ::isdigit)) {
-        size_t index = std::stoul(identifier);
-        if (index == 0 || index > activities.size()) {
-            throw std::out_of_range("Activity index is out of range!");
+    std::vector<ActivityId> candidates;
+    {
+        auto lock = readLock();
+        if (bool isNumber = std::all_of(identifier.begin(), identifier.end(), ::isdigit)) {
+            size_t index = std::stoul(identifier);
+            if (index == 0 || index > liveSlots.liveCount()) {
+                throw std::out_of_range("Activity index is out of range!");
+            }
+            const Activity& activity = activities[slotAt(index - 1)];
+            description = activity.getDescription();
+            return activity.getId();
         }
-        index--;
 
-        activities[index].setCompleted(true);
-        notifyObservers();
-        return;
-    }
-
-    std::vector<size_t> matchingIndexes;
-    for (size_t i = 0; i < activities.size(); ++i) {
-        if (activities[i].getDescription() == identifier) {
-            matchingIndexes.push_back(i);
+        for (size_t slot : slotsByDescription(identifier)) {
+            candidates.push_back(activities[slot].getId());
         }
     }
 
-    if (matchingIndexes.empty()) {
+    if (candidates.empty()) {
         throw std::out_of_range("No activity found with name '" + identifier + "'!");
     }
+    description = identifier;
+    if (candidates.size() == 1) {
+        return candidates.front();
+    }
 
-    size_t indexToMark = matchingIndexes[0];
+    std::cout << "Multiple activities found with name '" << identifier << "'. Choose which one to " << action << ":\n";
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        std::cout << i + 1 << ". " << identifier << "\n";
+    }
+    size_t choice;
+    std::cout << "Enter the number: ";
+    std::cin >> choice;
+    if (choice == 0 || choice > candidates.size()) {
+        throw std::invalid_argument("Invalid choice. Operation canceled.");
+    }
+    return candidates[choice - 1];
+}
 
-    if (matchingIndexes.size() > 1) {
-        std::cout << "Multiple activities found with name '" << identifier << "'. Choose which one to mark as completed:\n";
-        for (size_t i = 0; i < matchingIndexes.size(); ++i) {
-            std::cout << i + 1 << ". " << activities[matchingIndexes[i]].getDescription() << "\n";
-        }
-        size_t choice;
-        std::cout << "Enter the number: ";
-        std::cin >> choice;
-        if (choice == 0 || choice > matchingIndexes.size()) {
-            throw std::invalid_argument("Invalid choice. Operation canceled.");
-        }
-        indexToMark = matchingIndexes[choice - 1];
+void TodoList::removeActivity(ActivityId id) {
+    MutationScope scope(*this);
+    const size_t index = slotById(id);
+    if (index == std::string::npos) {
+        throw std::out_of_range("No activity found with id " + std::to_string(id) + "!");
     }
+    scope.notify(removeActivityAt(index));
+}
 
-    activities[indexToMark].setCompleted(true);
-    notifyObservers();
+void TodoList::markActivityAsCompleted(ActivityId id) {
+    MutationScope scope(*this);
+    const size_t index = slotById(id);
+    if (index == std::string::npos) {
+        throw std::out_of_range("No activity found with id " + std::to_string(id) + "!");
+    }
+    scope.notify(completeActivityAt(index));
+}
+
+void TodoList::markActivityAsCompleted(const std::string& identifier) {
+    std::string description;
+    markActivityAsCompleted(chooseActivity(identifier, "mark as completed", description));
 }
 
 // Edits an existing activity (description, completion status, due date)
 bool TodoList::editActivity(const std::string& identifier, const std::string& newDescription, bool changeCompletionStatus, bool newCompleted, bool changeDueDate, std::time_t newDueDate) {
     if (identifier.empty()) return false;
 
+    MutationScope scope(*this);
     bool isNumber = std::all_of(identifier.begin(), identifier.end(), ::isdigit);
     size_t index = std::string::npos;
 
     if (isNumber) {
         index = std::stoul(identifier);
-        if (index == 0 || index > activities.size()) return false;
-        index--;
+        if (index == 0 || index > liveSlots.liveCount()) return false;
+        index = slotAt(index - 1);
     } else {
-        auto it = std::find_if(activities.begin(), activities.end(),
-                               [&](const Activity& a) { return a.getDescription() == identifier; });
-
-        if (it == activities.end()) return false;
-        index = std::distance(activities.begin(), it);
+        const std::vector<size_t>& matchingIndexes = slotsByDescription(identifier);
+        if (matchingIndexes.empty()) return false;
+        index = matchingIndexes.front();
     }
 
-    Activity& activity = activities[index];
+    scope.notify(editActivityAt(index, newDescription, changeCompletionStatus, newCompleted, changeDueDate, newDueDate));
+    return true;
+}
 
-    if (!newDescription.empty()) {
-        activity.setDescription(newDescription);
-    }
+bool TodoList::editActivity(ActivityId id, const std::string& newDescription, bool changeCompletionStatus, bool newCompleted, bool changeDueDate, std::time_t newDueDate) {
+    MutationScope scope(*this);
+    const size_t index = slotById(id);
+    if (index == std::string::npos) return false;
+    scope.notify(editActivityAt(index, newDescription, changeCompletionStatus, newCompleted, changeDueDate, newDueDate));
+    return true;
+}
 
-    if (changeCompletionStatus) {
-        activity.setCompleted(newCompleted);
-    }
+// Edits the activity in a slot; the caller reports the returned event to observers
+ChangeEvent TodoList::editActivityAt(size_t index, const std::string& newDescription, bool changeCompletionStatus, bool newCompleted, bool changeDueDate, std::time_t newDueDate) {
+    ChangeEvent event;
+    event.type = ChangeType::Edited;
+    event.index = positionOf(index);
+    event.oldValue = activities[index];
 
-    if (changeDueDate) {
-        activity.setDueDate(newDueDate);
-    }
+    updateActivityAt(index, newDescription, changeCompletionStatus, newCompleted, changeDueDate, newDueDate);
+    checkpointIfNeeded();
 
-    notifyObservers();
-    return true;
+    event.newValue = activities[index];
+    return event;
 }
 
 std::string TodoList::toString() const {
+    auto lock = readLock();
     std::ostringstream output;
     output << "--- Todo List: " << name << " ---\n";
 
-    if (activities.empty()) {
+    if (liveSlots.liveCount() == 0) {
         output << "No activities to display.\n";
         return output.str();
     }
 
-    std::vector<Activity> sortedActivities = activities;
-    std::sort(sortedActivities.begin(), sortedActivities.end(),
-        [](const Activity& a, const Activity& b) {
-            return a.getDueDate() < b.getDueDate();
-        }
-    );
+    // The due date index already holds the display order, ties broken by list order
+    size_t number = 0;
+    for (size_t slot : dueDateOrder) {
+        if (!liveSlots.isLive(slot)) continue;
+        output << ++number << ". " << activities[slot].toString() << "\n";
+    }
+    return output.str();
+}
 
-    for (size_t i = 0; i < sortedActivities.size(); ++i) {
-        std::time_t dueDate = sortedActivities[i].getDueDate();
-        std::string dueDateStr = std::ctime(&dueDate);
-        dueDateStr.erase(dueDateStr.find_last_not_of('\n') + 1);
+void TodoList::noteChanged() {
+    snapshots.version.fetch_add(1, std::memory_order_release);
+}
 
-        output << i + 1 << ". " << sortedActivities[i].getDescription()
-               << " [" << (sortedActivities[i].isCompleted() ? "Done" : "Not Done") << "]"
-               << " (Due: " << dueDateStr << ")\n";
+void TodoList::noteSlotChanged(size_t slot) {
+    noteChanged();
+    const size_t chunk = slot / ActivityChunk::SIZE;
+    if (chunk >= snapshots.dirtyChunks.size()) {
+        snapshots.dirtyChunks.resize(chunk + 1, false);
     }
-    return output.str();
+    snapshots.dirtyChunks[chunk] = true;
 }
 
-// Saves the activities to a file
-void TodoList::saveToFile(const std::string& filename) const {
-    std::ofstream file(filename);
-    if (!file) { // File opening check
-        std::cerr << "Error opening file for writing: " << filename << std::endl;
-        return;
+void TodoList::noteOrderChanged() {
+    noteChanged();
+    snapshots.orderChanged = true;
+}
+
+void TodoList::noteAllChanged() {
+    noteChanged();
+    snapshots.allChanged = true;
+}
+
+// Publishes a new version built from the last one: chunks that were not touched since are shared, the rest
+// is copied from the current storage. The due date order is a copy-on-write copy of the index (its leaf pointers).
+std::shared_ptr<const ActivitySnapshot> TodoList::snapshot() const {
+    std::shared_ptr<const ActivitySnapshot> published = std::atomic_load(&snapshots.published);
+    if (published && published->getVersion() == snapshots.version.load(std::memory_order_acquire)) {
+        return published;
+    }
+
+    auto lock = readLock();
+    std::unique_lock<std::mutex> buildLock(locks.snapshotBuild, std::defer_lock);
+    if (locks.enabled) buildLock.lock();
+    published = std::atomic_load(&snapshots.published); // Another reader may have published it meanwhile
+    const uint64_t version = snapshots.version.load(std::memory_order_acquire);
+    if (published && published->getVersion() == version) {
+        return published;
     }
 
-    for (const auto& activity : activities) {
-        file << activity.serialize() << "\n";
+    const bool reuse = published && !snapshots.allChanged;
+    const size_t chunkCount = (activities.size() + ActivityChunk::SIZE - 1) / ActivityChunk::SIZE;
+    std::vector<std::shared_ptr<const ActivityChunk>> chunks(chunkCount);
+    for (size_t i = 0; i < chunkCount; ++i) {
+        const bool dirty = i < snapshots.dirtyChunks.size() && snapshots.dirtyChunks[i];
+        chunks[i] = reuse && !dirty && i < published->getChunkCount() ? published->getChunk(i)
+                                                                        : ActivityChunk::copyFrom(activities, liveSlots, i);
     }
+    auto order = reuse && !snapshots.orderChanged ? published->getDueDateOrder()
+                                                  : std::make_shared<const DueDateIndex>(dueDateOrder);
+
+    auto next = std::make_shared<const ActivitySnapshot>(name, std::move(chunks), std::move(order),
+                                                         liveSlots.liveCount(), version);
+    snapshots.dirtyChunks.assign(chunkCount, false);
+    snapshots.orderChanged = false;
+    snapshots.allChanged = false;
+    std::atomic_store(&snapshots.published, next);
+    return next;
+}
+
+// Saves the activities to a file
+void TodoList::saveToFile(const std::string& filename, FileFormat format, SaveMode mode) const {
+    auto lock = readLock();
+    writeActivitiesFile(filename, activities, format, mode, tombstones());
 }
 
 // Loads activities from a file and notifies observers
-void TodoList::loadFromFile(const std::string& filename) {
-    std::ifstream file(filename);
+void TodoList::loadFromFile(const std::string& filename, unsigned threads) {
+    std::ifstream file(filename, std::ios::in | std::ios::binary);
     if (!file) {
         throw std::runtime_error("Error opening file: " + filename);
     }
 
-    activities.clear();
-    std::string line;
-    while (std::getline(file, line)) {
-        activities.push_back(Activity::deserialize(line));
+    // Parse and replay into a temporary first so a malformed file leaves the list untouched;
+    // in concurrent mode readers keep running until the result is swapped in
+    TodoList loaded(getName());
+    if (detectFileFormat(file) == FileFormat::Binary) {
+        loaded.activities = readBinaryActivities(file);
+    } else {
+        // One bulk read, then the lines are parsed in parallel chunks
+        std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        if (threads == 0) {
+            threads = std::max(1U, std::thread::hardware_concurrency());
+        }
+        loaded.activities = parseTextActivities(text, threads);
+    }
+    loaded.rebuildIndexes();
+    loaded.replayJournal(Journal::readFor(filename));
+
+    MutationScope scope(*this);
+    activities = std::move(loaded.activities);
+    liveSlots = std::move(loaded.liveSlots);
+    columns = std::move(loaded.columns);
+    descriptionIndex = std::move(loaded.descriptionIndex);
+    dueDateOrder = std::move(loaded.dueDateOrder);
+    idIndex = std::move(loaded.idIndex);
+    nextId = loaded.nextId;
+    completedCount = loaded.completedCount;
+    descriptionBytes = loaded.descriptionBytes;
+    overdueAsOf = loaded.overdueAsOf;
+    overdueCount = loaded.overdueCount;
+    name = std::move(loaded.name);
+    noteAllChanged();
+    compactIfNeeded(); // Removals replayed from the journal may have left tombstones
+    if (journalSlot.journal) {
+        writeCheckpoint(); // The whole content changed: start the journal over from a fresh snapshot
+    }
+    scope.notify(ChangeEvent{}); // Notify observers after loading new activities (a Reloaded event)
+}
+
+// Re-applies journaled mutations; positions are validated since the journal may not match the snapshot
+void TodoList::replayJournal(const std::vector<JournalRecord>& records) {
+    for (const JournalRecord& record : records) {
+        const bool positional = record.op == JournalOp::Remove || record.op == JournalOp::SetCompleted || record.op == JournalOp::Edit;
+        if (positional && record.index >= liveSlots.liveCount()) {
+            throw std::runtime_error("Error: Journal does not match its snapshot (index out of range)");
+        }
+        const size_t slot = positional ? slotAt(record.index) : 0;
+
+        switch (record.op) {
+            case JournalOp::Add: {
+                Activity activity(record.text, record.completed, static_cast<std::time_t>(record.dueDate));
+                activity.setId(record.id);
+                appendActivity(activity);
+                break;
+            }
+            case JournalOp::Remove:
+                eraseActivityAt(slot);
+                break;
+            case JournalOp::SetCompleted:
+                setActivityCompletedAt(slot, record.completed);
+                break;
+            case JournalOp::Edit:
+                updateActivityAt(slot,
+                                 (record.editFlags & JOURNAL_EDIT_DESCRIPTION) ? record.text : std::string(),
+                                 (record.editFlags & JOURNAL_EDIT_COMPLETED) != 0, record.completed,
+                                 (record.editFlags & JOURNAL_EDIT_DUE_DATE) != 0, static_cast<std::time_t>(record.dueDate));
+                break;
+            case JournalOp::SetName:
+                name = record.text;
+                break;
+            case JournalOp::Checkpoint:
+                break;
+        }
     }
-    notifyObservers(); // Notify observers after loading new activities
+}
+
+// Attaches a journal and writes the initial checkpoint
+void TodoList::enableJournal(const std::string& snapshotFile, FileFormat format, size_t checkpointInterval, JournalSync sync) {
+    auto lock = writeLock();
+    journalSlot.journal = std::make_unique<Journal>(Journal::pathFor(snapshotFile), sync);
+    journalSlot.snapshotFile = snapshotFile;
+    journalSlot.snapshotFormat = format;
+    journalSlot.checkpointInterval = checkpointInterval;
+    writeCheckpoint();
+}
+
+void TodoList::disableJournal() {
+    auto lock = writeLock();
+    journalSlot = JournalSlot();
+}
+
+void TodoList::checkpoint() {
+    auto lock = writeLock();
+    writeCheckpoint();
+}
+
+// Writes the full snapshot, then truncates the journal; the name is re-journaled since snapshots do not store it
+void TodoList::writeCheckpoint() {
+    if (!journalSlot.journal) {
+        throw std::logic_error("Journal is not enabled.");
+    }
+    // Only truncate the journal once the snapshot is known to be written. Until then the old journal is
+    // tied to the old snapshot's fingerprint, so a crash in between does not replay it onto the new one.
+    writeActivitiesFile(journalSlot.snapshotFile, activities, journalSlot.snapshotFormat, SaveMode::Atomic, tombstones());
+    journalSlot.journal->reset(Journal::fingerprint(journalSlot.snapshotFile));
+    journalSlot.journal->appendSetName(name);
+    journalSlot.journal->sync();
+}
+
+void TodoList::checkpointIfNeeded() {
+    if (journalSlot.journal && journalSlot.checkpointInterval > 0 &&
+        journalSlot.journal->getRecordCount() > journalSlot.checkpointInterval) {
+        writeCheckpoint();
+    }
+}
+
+bool TodoList::isJournalEnabled() const {
+    auto lock = readLock();
+    return journalSlot.journal != nullptr;
 }
\ No newline at end of file
@@ -3,19 +3,201 @@
 
 #include "Activity.h"
 #include "Subject.h"
+#include "FileFormat.h"
+#include "Journal.h"
+#include "ActivityViews.h"
+#include "ActivityColumns.h"
+#include "LiveSlots.h"
+#include "ActivitySnapshot.h"
+#include "DueDateIndex.h"
+#include "ObserverDispatcher.h"
 #include <vector>
 #include <string>
+#include <unordered_map>
+#include <optional>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <shared_mutex>
+#include <type_traits>
+#include <iterator>
+#include <limits>
+#include <ctime>
 #include <fstream>
 #include <iostream>
 
+// Changes applied by TodoList::editActivities(); fields left unset (or an empty description) are not changed
+struct ActivityPatch {
+    std::optional<std::string> description;
+    std::optional<bool> completed;
+    std::optional<std::time_t> dueDate;
+};
+
+// Locks used by a TodoList in concurrent mode. Copies get fresh mutexes and only keep the mode,
+// so copying a list never shares lock state with the original.
+struct ListLocks {
+    mutable std::shared_mutex data;  // Shared by readers, exclusive for mutators
+    mutable std::mutex overdueCache; // Serializes readers that advance the cached overdue watermark
+    mutable std::mutex snapshotBuild; // Serializes readers that publish a new snapshot
+    // Writer turnstile: while a mutator waits, new readers queue behind it instead of starving it
+    // (std::shared_mutex may prefer readers)
+    mutable std::mutex writerTurn;
+    mutable std::atomic<size_t> waitingWriters{0};
+    bool enabled = false;
+
+    ListLocks() = default;
+    ListLocks(const ListLocks& other) : enabled(other.enabled) {}
+    ListLocks& operator=(const ListLocks& other) {
+        enabled = other.enabled;
+        return *this;
+    }
+};
+
+// Last snapshot published by a TodoList and what changed since it was built
+struct SnapshotCache {
+    std::shared_ptr<const ActivitySnapshot> published; // Only accessed through std::atomic_load / atomic_store
+    std::atomic<uint64_t> version{0}; // Bumped by every mutation
+    std::vector<bool> dirtyChunks;    // Chunks written since `published` was built
+    bool orderChanged = false;        // dueDateOrder changed since `published` was built
+    bool allChanged = false;          // Slots were renumbered (compaction, load): nothing can be shared
+
+    SnapshotCache() = default;
+    SnapshotCache(const SnapshotCache& other)
+        : published(std::atomic_load(&other.published)), version(other.version.load()), dirtyChunks(other.dirtyChunks),
+          orderChanged(other.orderChanged), allChanged(other.allChanged) {}
+    SnapshotCache& operator=(const SnapshotCache& other) {
+        std::atomic_store(&published, std::atomic_load(&other.published));
+        version = other.version.load();
+        dirtyChunks = other.dirtyChunks;
+        orderChanged = other.orderChanged;
+        allChanged = other.allChanged;
+        return *this;
+    }
+};
+
 // The TodoList class manages a list of activities and notifies observers of any changes.
 class TodoList : public Subject { // Inherit from Subject
 private:
+    static constexpr size_t MIN_TOMBSTONES_TO_COMPACT = 1024;
+
     std::string name;
-    std::vector<Activity> activities; // Stores the list of activities
+    // Stores the activities by slot. Removing an activity only leaves a tombstone in its slot;
+    // slots are in list order, and compaction squeezes the tombstones out once they outnumber live activities.
+    std::vector<Activity> activities;
+    LiveSlots liveSlots; // Which slots are live; converts between slots and list positions
+    ActivityColumns columns; // Due dates and completion bits by slot, as packed columns for scans
     std::vector<Observer*> observers; // Stores a list of registered observers
+    size_t batchDepth = 0; // Number of active Batch scopes
+    bool batchChanged = false; // Whether a mutation happened inside the current batch
+    JournalSlot journalSlot; // Optional write-ahead journal of mutations
+    std::unordered_map<std::string, std::vector<size_t>> descriptionIndex; // Description -> ascending slots
+    DueDateIndex dueDateOrder; // Slots sorted by (due date, slot); may still hold tombstones
+
+    std::unordered_map<ActivityId, size_t> idIndex; // Id -> slot
+    ActivityId nextId = 1; // Next id handed out; always greater than every id in the list
+    size_t completedCount = 0; // Maintained by every mutation, so pending/completed counts are O(1)
+    size_t descriptionBytes = 0; // Total description length of every slot (tombstones too, until compaction)
+    // Number of pending activities due before overdueAsOf; advanced lazily by getOverdueActivities()
+    mutable std::time_t overdueAsOf = std::numeric_limits<std::time_t>::min();
+    mutable size_t overdueCount = 0;
+    bool dueDateOrderDeferred = false; // Set by addActivities(), which indexes the new slots once at the end
+    ListLocks locks; // Only taken in concurrent mode
+    mutable SnapshotCache snapshots;
+    std::shared_ptr<ObserverDispatcher> dispatcher; // Only accessed through std::atomic_load / atomic_store; null = synchronous
+    // Exceptions our observers threw on the dispatcher thread, until flushNotifications() rethrows them
+    std::shared_ptr<ObserverDispatcher::ErrorSlot> observerErrors = std::make_shared<ObserverDispatcher::ErrorSlot>();
+
+    // Record what a mutation touched, so the next snapshot only copies that
+    void noteChanged();
+    void noteSlotChanged(size_t slot);
+    void noteOrderChanged();
+    void noteAllChanged();
+
+    [[nodiscard]] std::vector<Observer*> observersToNotify() const;
+    // Return owning locks in concurrent mode and empty ones otherwise
+    [[nodiscard]] std::shared_lock<std::shared_mutex> readLock() const;
+    [[nodiscard]] std::unique_lock<std::shared_mutex> writeLock();
+
+    // Holds the write lock for one public mutation and delivers its change event after releasing it,
+    // so observers can read the list from their callbacks
+    class MutationScope {
+    private:
+        TodoList& list;
+        std::unique_lock<std::shared_mutex> lock;
+
+    public:
+        explicit MutationScope(TodoList& todoList);
+        // Releases the lock, then notifies observers (or only records the change while a batch is active)
+        void notify(const ChangeEvent& event);
+        // Releases the lock and notifies observers, with no journal sync and no batch check
+        void deliver(const ChangeEvent& event);
+    };
+
+    // Returns the ascending slots of the activities with the given description (empty if none)
+    [[nodiscard]] const std::vector<size_t>& slotsByDescription(const std::string& description) const;
+    // Rebuilds every index from scratch after the activities were replaced wholesale
+    void rebuildIndexes();
+    // Returns the slot of the activity with the given id, or npos
+    [[nodiscard]] size_t slotById(ActivityId id) const;
+    // Conversions between 0-based list positions and slots (identity while there are no tombstones)
+    [[nodiscard]] size_t slotAt(size_t position) const;
+    [[nodiscard]] size_t positionOf(size_t slot) const;
+    // The live slot set to hand to views and writers, or nullptr when no slot is a tombstone
+    [[nodiscard]] const LiveSlots* tombstones() const;
+    // Compacts once tombstones outnumber live activities (and there are enough of them to be worth it)
+    void compactIfNeeded();
+    void compactSlots();
+    // Debug checks of the cached counters; the overdue one expects the overdue cache lock to be held
+    [[nodiscard]] bool completedCountMatches() const;
+    [[nodiscard]] bool overdueCountMatches() const;
+    // Gives the activity a fresh id unless it already holds one that is free
+    void assignId(Activity& activity);
+    // Add/remove the activity at a position to/from the cached counters
+    void countActivityAt(size_t index);
+    void uncountActivityAt(size_t index);
+
+    // Low-level mutations by slot, shared by the public API and journal replay; they record to the journal
+    // (by list position) but do not notify
+    void appendActivity(Activity activity);
+    void eraseActivityAt(size_t index);
+    // eraseActivityAt() without the description index update, which bulk removals do in one sweep
+    void tombstoneActivityAt(size_t index);
+    void setActivityCompletedAt(size_t index, bool completed);
+    void updateActivityAt(size_t index, const std::string& newDescription, bool changeCompletionStatus, bool newCompleted, bool changeDueDate, std::time_t newDueDate);
+    // Public-level single-activity mutations by slot: primitive + checkpoint; they return the change event to deliver
+    ChangeEvent removeActivityAt(size_t index);
+    ChangeEvent completeActivityAt(size_t index);
+    ChangeEvent editActivityAt(size_t index, const std::string& newDescription, bool changeCompletionStatus, bool newCompleted, bool changeDueDate, std::time_t newDueDate);
+    // Resolves an identifier (1-based position or name) to an id and sets description to the activity's;
+    // duplicate names are offered to the user as a "Choose which one to <action>" prompt, with no lock held
+    [[nodiscard]] ActivityId chooseActivity(const std::string& identifier, const std::string& action, std::string& description) const;
+    // Saves the snapshot and truncates the journal (the caller holds the write lock)
+    void writeCheckpoint();
+    // Checkpoints once the journal has grown past the configured interval
+    void checkpointIfNeeded();
+    // Applies journal records on top of the current activities
+    void replayJournal(const std::vector<JournalRecord>& records);
+
+    // Bulk operations: the template loops call the primitives, these finish the job once
+    void reserveActivities(size_t additional);
+    void finishBulkAdd(size_t firstSlot, MutationScope& scope);
+    void finishBulkRemoval(size_t removed, MutationScope& scope);
+    void finishBulkEdit(size_t edited, MutationScope& scope);
 
 public:
+    // RAII scope that suppresses per-mutation notifications; when the outermost scope ends,
+    // observers receive a single Reloaded event if anything changed. Scopes may be nested.
+    class Batch {
+    private:
+        TodoList& list;
+
+    public:
+        explicit Batch(TodoList& todoList);
+        ~Batch();
+        Batch(const Batch&) = delete;
+        Batch& operator=(const Batch&) = delete;
+    };
+
     // Default constructor (needed for std::map)
     TodoList();
     // Modify constructor to accept a name
@@ -31,37 +213,193 @@ public:
     // Removes an observer from the notification list
     void removeObserver(Observer* observer) override;
     void notifyObservers() const override;
+    void notifyObservers(const ChangeEvent& event) const override;
 
-    // Adds a new activity to the list and notifies observers
-    void addActivity(const Activity& activity);
+    // Adds a new activity to the list and notifies observers; returns the id it is stored under
+    // (the activity's own id if it has a free one, otherwise a fresh one)
+    ActivityId addActivity(const Activity& activity);
     // Removes an activity by index (if numeric) or by name and notifies observers
     void removeActivity(const std::string& identifier, bool skipConfirmation = false);
+    // Removes the activity with the given id without confirmation (throws std::out_of_range if there is none)
+    void removeActivity(ActivityId id);
     // Marks an activity as completed by index or name and notifies observers
     void markActivityAsCompleted(const std::string& identifier);
+    // Marks the activity with the given id as completed (throws std::out_of_range if there is none)
+    void markActivityAsCompleted(ActivityId id);
 
     // Edits an activity's details (description, completion status, due date)
     bool editActivity(const std::string& identifier, const std::string& newDescription, bool updateCompleted, bool newCompletedStatus, bool updateDueDate, std::time_t newDueDate);
+    // Edits the activity with the given id; returns false if there is none
+    bool editActivity(ActivityId id, const std::string& newDescription, bool updateCompleted, bool newCompletedStatus, bool updateDueDate, std::time_t newDueDate);
+
+    // Bulk mutations: each one makes a single pass and notifies observers once (a Reloaded event), if anything changed.
+    // Appends every activity of a range, moving from it when it is an rvalue; returns the number added
+    template <typename Range>
+    size_t addActivities(Range&& range) {
+        using Iterator = decltype(std::begin(range));
+        MutationScope scope(*this); // Before reserving: growing the storage moves what readers may be looking at
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<Iterator>::iterator_category>) {
+            reserveActivities(static_cast<size_t>(std::distance(std::begin(range), std::end(range))));
+        }
+        const size_t firstSlot = activities.size();
+        dueDateOrderDeferred = true;
+        try {
+            for (auto&& activity : range) {
+                if constexpr (std::is_lvalue_reference_v<Range>) {
+                    appendActivity(activity);
+                } else {
+                    appendActivity(std::move(activity));
+                }
+            }
+        } catch (...) {
+            finishBulkAdd(firstSlot, scope);
+            throw;
+        }
+        const size_t added = activities.size() - firstSlot;
+        finishBulkAdd(firstSlot, scope);
+        return added;
+    }
+
+    // Removes every activity matching the predicate; returns the number removed
+    template <typename Predicate>
+    size_t removeActivities(Predicate predicate) {
+        MutationScope scope(*this);
+        size_t removed = 0;
+        try {
+            for (size_t slot = 0; slot < activities.size(); ++slot) {
+                if (liveSlots.isLive(slot) && predicate(static_cast<const Activity&>(activities[slot]))) {
+                    tombstoneActivityAt(slot);
+                    ++removed;
+                }
+            }
+        } catch (...) {
+            finishBulkRemoval(removed, scope);
+            throw;
+        }
+        finishBulkRemoval(removed, scope);
+        return removed;
+    }
+
+    // Marks every pending activity matching the predicate as completed; returns the number changed
+    template <typename Predicate>
+    size_t markActivitiesAsCompleted(Predicate predicate) {
+        return editActivities([&predicate](const Activity& activity) {
+            return !activity.isCompleted() && predicate(activity);
+        }, ActivityPatch{std::nullopt, true, std::nullopt});
+    }
+
+    // Applies the patch to every activity matching the predicate; returns the number edited
+    template <typename Predicate>
+    size_t editActivities(Predicate predicate, const ActivityPatch& patch) {
+        MutationScope scope(*this);
+        size_t edited = 0;
+        try {
+            for (size_t slot = 0; slot < activities.size(); ++slot) {
+                if (liveSlots.isLive(slot) && predicate(static_cast<const Activity&>(activities[slot]))) {
+                    ++edited; // First, so a failed journal write still notifies
+                    updateActivityAt(slot, patch.description.value_or(std::string()),
+                                     patch.completed.has_value(), patch.completed.value_or(false),
+                                     patch.dueDate.has_value(), patch.dueDate.value_or(0));
+                }
+            }
+        } catch (...) {
+            finishBulkEdit(edited, scope);
+            throw;
+        }
+        finishBulkEdit(edited, scope);
+        return edited;
+    }
+
+    // Returns the activity with the given id, or nullptr (invalidated by any change to the list; not synchronized)
+    [[nodiscard]] const Activity* findActivityById(ActivityId id) const;
 
     // Converts the TodoList activities to a formatted string
     [[nodiscard]] std::string toString() const;
 
-    // Saves the list of activities to a file
-    void saveToFile(const std::string& filename) const;
-    // Loads activities from a file and notifies observers
-    void loadFromFile(const std::string& filename);
+    // Saves the list of activities to a file in the requested format (text by default).
+    // Throws std::runtime_error on failure; SaveMode::Atomic never leaves a partially written file behind.
+    void saveToFile(const std::string& filename, FileFormat format = FileFormat::Text, SaveMode mode = SaveMode::InPlace) const;
+    // Loads activities from a file (text or binary, detected by magic bytes) and notifies observers once.
+    // Large text files are parsed on up to `threads` threads (0 = one per core).
+    void loadFromFile(const std::string& filename, unsigned threads = 0);
+
+    // Records every mutation in "<snapshotFile>.journal" and rewrites snapshotFile every checkpointInterval records.
+    // Enabling writes an initial checkpoint, so load a previous snapshot first to resume from it.
+    // By default records only survive a crash of the process; see JournalSync for fsync per record or per mutation.
+    void enableJournal(const std::string& snapshotFile, FileFormat format = FileFormat::Binary, size_t checkpointInterval = 1024,
+                       JournalSync sync = JournalSync::Process);
+    // Stops journaling (the files on disk are kept; saving over the snapshot file afterwards retires the journal)
+    void disableJournal();
+    // Saves the snapshot file and truncates the journal
+    void checkpoint();
+    [[nodiscard]] bool isJournalEnabled() const;
+
+    // Drops the tombstones left by removals now, instead of waiting for them to outnumber live activities
+    void compact();
+
+    // Asynchronous notifications: observers are called on the dispatcher's thread, in the order the changes
+    // were notified, and mutations only pay for queueing them. Observers that read the list from their
+    // callbacks then need concurrent mode. Passing nullptr delivers what is queued and goes back to
+    // synchronous calls. One dispatcher can serve many lists.
+    void setDispatcher(std::shared_ptr<ObserverDispatcher> newDispatcher);
+    [[nodiscard]] std::shared_ptr<ObserverDispatcher> getDispatcher() const;
+    // Waits until observers have received every change made so far (no-op when synchronous), then rethrows
+    // the first exception one of this list's observers threw from the dispatcher thread
+    void flushNotifications() const;
+
+    // Immutable version of the list, readable from any thread without locks while the list keeps changing.
+    // An unchanged list hands out its last published snapshot without locking; otherwise only the chunks
+    // changed since then are copied (the first call copies the whole list), and the due date order shares
+    // every leaf the list has not changed since.
+    [[nodiscard]] std::shared_ptr<const ActivitySnapshot> snapshot() const;
+
+    // Concurrent mode: readers (toString, find*, get*Activities, saveToFile) run in parallel and only
+    // mutators take the lock exclusively; observers are notified after the lock is released.
+    // Switch it on before the list is shared between threads.
+    void setConcurrentMode(bool enabled);
+    [[nodiscard]] bool isConcurrentMode() const;
 
     // Returns a reference to the activity list (marked [[nodiscard]] to prevent ignored return values)
     [[nodiscard]] std::vector<Activity> getActivities() const;
 
+    // Zero-copy alternatives to the accessors above; views are invalidated by any change to the list
+    // and are not synchronized, so in concurrent mode use the copying accessors instead
+    // Returns a view of all activities in list order
+    [[nodiscard]] ActivitySpan viewActivities() const;
+    // Returns a view of the activities with a given name, in list order
+    [[nodiscard]] ActivityPositionsView viewActivitiesByName(const std::string& name) const;
+    // Returns a view of the activities due between from and to (inclusive), sorted by due date
+    [[nodiscard]] ActivityDueDateView viewActivitiesDueBetween(std::time_t from, std::time_t to) const;
+    // Returns a lazily filtered view of the activities matching a predicate
+    template <typename Predicate>
+    [[nodiscard]] FilteredActivityView<Predicate> viewActivitiesWhere(Predicate predicate) const {
+        return FilteredActivityView<Predicate>(viewActivities(), std::move(predicate));
+    }
+
     // Returns the total number of activities
     [[nodiscard]] size_t getTotalActivities() const;
     // Returns the number of pending (not completed) activities
     [[nodiscard]] size_t getPendingActivities() const;
+    // Returns the number of completed activities
+    [[nodiscard]] size_t getCompletedActivities() const;
+    // Returns the number of pending activities whose due date is before now.
+    // O(1) when now does not change; moving now forward only visits the activities that became due.
+    [[nodiscard]] size_t getOverdueActivities(std::time_t now = std::time(nullptr)) const;
+    // Rough estimate of the memory held by the list (storage, indexes and descriptions), in O(1)
+    [[nodiscard]] size_t getMemoryUsage() const;
+    // Number of changes made to the list so far; equal versions of one list mean equal contents
+    [[nodiscard]] uint64_t getVersion() const;
+    // Recomputes the counters from scratch and compares them with the cached values (checked on every read in debug builds)
+    [[nodiscard]] bool countersAreConsistent() const;
 
     // Finds all activities with a given name
     [[nodiscard]] std::vector<Activity> findActivitiesByName(const std::string& name) const;
     // Finds all activities with a given due date
     [[nodiscard]] std::vector<Activity> findActivitiesByDueDate(std::time_t dueDate) const;
+    // Finds all activities due between from and to (inclusive), sorted by due date
+    [[nodiscard]] std::vector<Activity> findActivitiesDueBetween(std::time_t from, std::time_t to) const;
+    // Returns up to k pending activities due at or after from, earliest first
+    [[nodiscard]] std::vector<Activity> nextDue(size_t k, std::time_t from = std::time(nullptr)) const;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,395 @@
+#include "TodoListStore.h"
+#include <algorithm>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+
+TodoListStore::TodoListStore(size_t shardsWanted) : shardCount(std::max<size_t>(1, shardsWanted)) {
+    shards = std::make_unique<Shard[]>(shardCount);
+}
+
+TodoListStore::~TodoListStore() {
+    for (size_t i = 0; i < shardCount; ++i) {
+        for (const auto& [name, entry] : shards[i].lists) {
+            if (entry.ownsFile) {
+                std::error_code ignored;
+                std::filesystem::remove(entry.filename, ignored);
+            }
+        }
+    }
+}
+
+size_t TodoListStore::shardIndex(const std::string& name) const {
+    return std::hash<std::string>{}(name) % shardCount;
+}
+
+void TodoListStore::checkName(const std::string& name) {
+    if (name.empty()) {
+        throw std::invalid_argument("TodoList name cannot be empty!");
+    }
+}
+
+void TodoListStore::insert(const std::string& name, Entry entry) {
+    checkName(name);
+    Shard& shard = shards[shardIndex(name)];
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    if (!shard.lists.emplace(name, std::move(entry)).second) {
+        throw std::invalid_argument("TodoList '" + name + "' already exists!");
+    }
+    ++listCount;
+}
+
+void TodoListStore::track(Entry& entry) {
+    entry.bytes = entry.list->getMemoryUsage();
+    entry.referenced = true;
+    residentBytes += entry.bytes;
+    ++loadedCount;
+}
+
+// Unsigned wrap-around makes the difference right for shrinking lists too
+void TodoListStore::retrack(Entry& entry, size_t bytes) {
+    residentBytes += bytes - entry.bytes.exchange(bytes);
+}
+
+std::shared_ptr<TodoList> TodoListStore::create(const std::string& name) {
+    auto list = std::make_shared<TodoList>(name);
+    Entry entry;
+    entry.list = list;
+    entry.bytes = list->getMemoryUsage();
+    entry.referenced = true;
+    const size_t bytes = entry.bytes;
+    insert(name, std::move(entry));
+    residentBytes += bytes;
+    ++loadedCount;
+    sweep(true);
+    return list;
+}
+
+void TodoListStore::attach(const std::string& name, const std::string& filename) {
+    Entry entry;
+    entry.filename = filename;
+    insert(name, std::move(entry));
+}
+
+// Loaded lists only need the shared lock. A first access marks the entry as loading and reads the file with
+// no lock held, so a slow load only holds up the callers that want that same list.
+// Under a budget, the list found is re-estimated outside the shard lock (that takes the list's own lock).
+std::shared_ptr<TodoList> TodoListStore::find(const std::string& name) {
+    Shard& shard = shards[shardIndex(name)];
+    std::shared_ptr<TodoList> found;
+    {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        auto it = shard.lists.find(name);
+        if (it == shard.lists.end()) return nullptr;
+        if (it->second.list) {
+            it->second.referenced = true;
+            found = it->second.list;
+        }
+    }
+    if (found) {
+        if (memoryBudget.load() == 0) return found;
+        const size_t bytes = found->getMemoryUsage();
+        {
+            std::shared_lock<std::shared_mutex> lock(shard.mutex);
+            auto it = shard.lists.find(name);
+            if (it != shard.lists.end() && it->second.list == found) {
+                retrack(it->second, bytes);
+            }
+        }
+        sweep(true);
+        return found;
+    }
+
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.lists.find(name);
+    if (it == shard.lists.end()) return nullptr;
+    Entry& entry = it->second;
+    if (entry.list) {
+        entry.referenced = true;
+        return entry.list;
+    }
+    if (entry.loading) {
+        std::shared_future<std::shared_ptr<TodoList>> result = entry.loading->result;
+        lock.unlock();
+        return result.get(); // Rethrows the error of the load it waited for
+    }
+
+    auto loading = std::make_shared<PendingLoad>();
+    entry.loading = loading;
+    const std::string filename = entry.filename;
+    const bool keepFormat = !entry.ownsFile; // Written back in the format it came in
+    lock.unlock();
+
+    // Only publishes into the entry that started this load: it may have been removed (and the name reused) meanwhile
+    auto loadingEntry = [&]() -> Entry* {
+        auto current = shard.lists.find(name);
+        return current != shard.lists.end() && current->second.loading == loading ? &current->second : nullptr;
+    };
+
+    auto list = std::make_shared<TodoList>(name);
+    FileFormat format = FileFormat::Binary;
+    try {
+        list->loadFromFile(filename);
+        if (list->getName() != name) {
+            list->setName(name); // A journal may still carry the name the list had when it was saved
+        }
+        if (keepFormat) {
+            std::ifstream file(filename, std::ios::in | std::ios::binary);
+            format = detectFileFormat(file);
+        }
+    } catch (...) {
+        lock.lock();
+        if (Entry* failed = loadingEntry()) {
+            failed->loading.reset();
+        }
+        lock.unlock();
+        loading->promise.set_exception(std::current_exception());
+        throw;
+    }
+
+    lock.lock();
+    if (Entry* loaded = loadingEntry()) {
+        loaded->loading.reset();
+        if (keepFormat) {
+            loaded->format = format;
+        }
+        loaded->savedVersion = list->getVersion();
+        loaded->list = list;
+        track(*loaded);
+    }
+    lock.unlock();
+    loading->promise.set_value(list);
+    sweep(true);
+    return list;
+}
+
+bool TodoListStore::contains(const std::string& name) const {
+    const Shard& shard = shards[shardIndex(name)];
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    return shard.lists.count(name) != 0;
+}
+
+bool TodoListStore::isLoaded(const std::string& name) const {
+    const Shard& shard = shards[shardIndex(name)];
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.lists.find(name);
+    return it != shard.lists.end() && it->second.list != nullptr;
+}
+
+// Both shards are locked (in index order, so concurrent renames cannot deadlock) while the entry moves.
+// The list itself is renamed after the locks are released, since its observers may use the store.
+void TodoListStore::rename(const std::string& oldName, const std::string& newName) {
+    checkName(newName);
+    const size_t from = shardIndex(oldName);
+    const size_t to = shardIndex(newName);
+    for (;;) {
+        std::unique_lock<std::shared_mutex> first(shards[std::min(from, to)].mutex);
+        std::unique_lock<std::shared_mutex> second;
+        if (from != to) {
+            second = std::unique_lock<std::shared_mutex>(shards[std::max(from, to)].mutex);
+        }
+
+        auto it = shards[from].lists.find(oldName);
+        if (it == shards[from].lists.end()) {
+            throw std::out_of_range("TodoList '" + oldName + "' not found!");
+        }
+        if (oldName == newName) return;
+        if (shards[to].lists.count(newName) != 0) {
+            throw std::invalid_argument("TodoList '" + newName + "' already exists!");
+        }
+        if (it->second.loading || it->second.evicting) {
+            // Loads and evictions look the entry up under the name they started with: let them finish, then look again
+            std::shared_ptr<PendingLoad> loading = it->second.loading;
+            std::shared_ptr<PendingEviction> evicting = it->second.evicting;
+            if (second.owns_lock()) second.unlock();
+            first.unlock();
+            if (loading) {
+                loading->result.wait();
+            } else {
+                evicting->done.wait();
+            }
+            continue;
+        }
+        Entry entry = std::move(it->second);
+        shards[from].lists.erase(it);
+        std::shared_ptr<TodoList> list = entry.list;
+        shards[to].lists.emplace(newName, std::move(entry));
+
+        if (second.owns_lock()) second.unlock();
+        first.unlock();
+        if (list) {
+            list->setName(newName);
+        }
+        return;
+    }
+}
+
+bool TodoListStore::remove(const std::string& name) {
+    Shard& shard = shards[shardIndex(name)];
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.lists.find(name);
+    while (it != shard.lists.end() && it->second.evicting) {
+        // Otherwise the eviction could write a paging file after the entry that owns it is gone
+        std::shared_future<void> done = it->second.evicting->done;
+        lock.unlock();
+        done.wait();
+        lock.lock();
+        it = shard.lists.find(name);
+    }
+    if (it == shard.lists.end()) return false;
+    if (it->second.list) {
+        residentBytes -= it->second.bytes;
+        --loadedCount;
+    }
+    if (it->second.ownsFile) {
+        std::error_code ignored;
+        std::filesystem::remove(it->second.filename, ignored);
+    }
+    shard.lists.erase(it);
+    --listCount;
+    return true;
+}
+
+std::vector<std::string> TodoListStore::getNames() const {
+    std::vector<std::string> names;
+    names.reserve(size());
+    for (size_t i = 0; i < shardCount; ++i) {
+        std::shared_lock<std::shared_mutex> lock(shards[i].mutex);
+        for (const auto& [name, entry] : shards[i].lists) {
+            names.push_back(name);
+        }
+    }
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+size_t TodoListStore::size() const {
+    return listCount.load();
+}
+
+void TodoListStore::setMemoryBudget(size_t budgetBytes, const std::string& directory) {
+    {
+        std::lock_guard<std::mutex> lock(sweepMutex);
+        if (budgetBytes > 0) {
+            std::filesystem::create_directories(directory);
+        }
+        pagingDirectory = directory;
+        memoryBudget = budgetBytes;
+    }
+    enforceMemoryBudget();
+}
+
+size_t TodoListStore::getMemoryBudget() const {
+    return memoryBudget.load();
+}
+
+void TodoListStore::enforceMemoryBudget() {
+    if (memoryBudget.load() == 0) return;
+    for (size_t i = 0; i < shardCount; ++i) {
+        std::shared_lock<std::shared_mutex> lock(shards[i].mutex);
+        for (auto& [name, entry] : shards[i].lists) {
+            if (entry.list) {
+                retrack(entry, entry.list->getMemoryUsage());
+            }
+        }
+    }
+    sweep(false);
+}
+
+size_t TodoListStore::getResidentBytes() const {
+    return residentBytes.load();
+}
+
+size_t TodoListStore::getLoadedCount() const {
+    return loadedCount.load();
+}
+
+// The save (with its fsyncs) runs with no shard lock held, so it only holds up rename() and remove() of this
+// list; find() still returns it meanwhile, which keeps it loaded.
+void TodoListStore::evict(Shard& shard, const std::string& name) {
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    Entry& entry = shard.lists.at(name); // rename() and remove() wait for the eviction
+    std::shared_ptr<PendingEviction> pending = entry.evicting;
+    if (entry.filename.empty()) {
+        entry.filename = (std::filesystem::path(pagingDirectory) /
+                          ("todolist-" + std::to_string(nextPagingFile++) + ".tdl")).string();
+        entry.format = FileFormat::Binary;
+        entry.ownsFile = true;
+    }
+    std::shared_ptr<TodoList> list = entry.list;
+    const std::string filename = entry.filename;
+    const FileFormat format = entry.format;
+    const uint64_t version = list->getVersion();
+    const bool stale = entry.savedVersion != version;
+    lock.unlock();
+
+    std::exception_ptr error;
+    if (stale) {
+        try {
+            list->saveToFile(filename, format, SaveMode::Atomic);
+        } catch (...) {
+            error = std::current_exception();
+        }
+    }
+
+    lock.lock();
+    Entry& current = shard.lists.at(name);
+    current.evicting.reset();
+    if (!error) {
+        current.savedVersion = version;
+        // Only this copy and the entry's are left, and the file holds what the list holds
+        if (current.list.use_count() == 2 && list->getVersion() == version) {
+            residentBytes -= current.bytes.exchange(0);
+            --loadedCount;
+            current.list.reset();
+        }
+    }
+    lock.unlock();
+    pending->promise.set_value();
+    if (error) std::rethrow_exception(error);
+}
+
+// The hand moves over the shards; within a shard, marked lists lose their mark and unmarked ones are
+// picked under the shard lock, then evicted after it is released. Two turns are enough: the first clears
+// every mark it passes. A failed save does not stop the sweep; a loud one rethrows the first error at the end.
+void TodoListStore::sweep(bool quiet) {
+    const size_t budget = memoryBudget.load();
+    if (budget == 0 || residentBytes.load() <= budget) return;
+    std::unique_lock<std::mutex> sweepLock(sweepMutex, std::defer_lock);
+    if (quiet) {
+        if (!sweepLock.try_lock()) return;
+    } else {
+        sweepLock.lock();
+    }
+
+    std::exception_ptr error;
+    for (size_t step = 0; step < 2 * shardCount && residentBytes.load() > budget; ++step) {
+        Shard& shard = shards[clockHand];
+        clockHand = (clockHand + 1) % shardCount;
+        std::vector<std::string> victims;
+        {
+            std::unique_lock<std::shared_mutex> lock(shard.mutex);
+            size_t picked = 0; // Bytes the victims will free
+            for (auto& [name, entry] : shard.lists) {
+                if (residentBytes.load() <= budget + picked) break;
+                if (!entry.list || entry.evicting || entry.referenced.exchange(false)) continue;
+                if (entry.list.use_count() > 1) continue; // Someone still works on it: reloading would fork the list
+                entry.evicting = std::make_shared<PendingEviction>();
+                picked += entry.bytes;
+                victims.push_back(name);
+            }
+        }
+        for (const std::string& name : victims) {
+            try {
+                evict(shard, name);
+            } catch (...) {
+                if (!error) error = std::current_exception();
+            }
+        }
+    }
+    if (error && !quiet) std::rethrow_exception(error);
+}
@@ -0,0 +1,141 @@
+#ifndef TODOLISTSTORE_H
+#define TODOLISTSTORE_H
+
+#include "TodoList.h"
+#include <atomic>
+#include <cstddef>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Named TodoLists, spread over hashed shards that each have their own reader-writer lock, so threads
+// working on different lists rarely contend. Lists are held through shared_ptr: renaming only moves the
+// handle, and a handle stays valid after its list is renamed or removed from the store.
+// Lists attached from a file are loaded on first access. The store only guards its own table: share a
+// list between threads in the list's concurrent mode (TodoList::setConcurrentMode()).
+//
+// With a memory budget, the store pages lists out: when the estimated memory of the loaded lists exceeds
+// the budget, a CLOCK sweep evicts lists that were not accessed since its previous pass (every find()
+// marks a list, and the sweep spares a marked list once). The total is kept up to date by re-estimating
+// only the list being created, loaded or found, so no call has to visit every list to check the budget.
+// Evicted lists are saved first if they changed, to their own file or, for lists created in memory, to a file
+// in the paging directory, and find() reloads them transparently. The save runs with no shard lock held.
+// A list whose handle is still held outside the store is never evicted.
+class TodoListStore {
+private:
+    // A load running outside the shard lock; later callers for the same list wait on its result
+    struct PendingLoad {
+        std::promise<std::shared_ptr<TodoList>> promise;
+        std::shared_future<std::shared_ptr<TodoList>> result = promise.get_future().share();
+    };
+
+    // An eviction saving the list outside the shard lock; rename() and remove() wait for it
+    struct PendingEviction {
+        std::promise<void> promise;
+        std::shared_future<void> done = promise.get_future().share();
+    };
+
+    struct Entry {
+        std::shared_ptr<TodoList> list; // Null until the list is loaded from filename (or after eviction)
+        std::shared_ptr<PendingLoad> loading; // Set while a find() loads the list
+        std::shared_ptr<PendingEviction> evicting; // Set while the sweep saves the list to drop it
+        std::string filename;
+        FileFormat format = FileFormat::Binary;
+        bool ownsFile = false;                // A paging file, deleted along with the entry
+        std::optional<uint64_t> savedVersion; // List version the file holds; unset while the file is missing
+        std::atomic<size_t> bytes{0};         // Memory estimate counted in residentBytes
+        std::atomic<bool> referenced{false};  // CLOCK mark, set by every access
+
+        Entry() = default;
+        Entry(Entry&& other) noexcept
+            : list(std::move(other.list)), loading(std::move(other.loading)), evicting(std::move(other.evicting)),
+              filename(std::move(other.filename)), format(other.format),
+              ownsFile(other.ownsFile), savedVersion(other.savedVersion), bytes(other.bytes.load()),
+              referenced(other.referenced.load()) {}
+    };
+
+    struct Shard {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<std::string, Entry> lists;
+    };
+
+    std::unique_ptr<Shard[]> shards;
+    size_t shardCount;
+    std::atomic<size_t> listCount{0};
+
+    std::atomic<size_t> memoryBudget{0}; // 0 = no budget
+    std::atomic<size_t> residentBytes{0};
+    std::atomic<size_t> loadedCount{0};
+    std::mutex sweepMutex; // One sweep at a time; guards the fields below
+    std::string pagingDirectory;
+    size_t clockHand = 0; // Next shard visited by the sweep
+    size_t nextPagingFile = 0;
+
+    [[nodiscard]] size_t shardIndex(const std::string& name) const;
+    // Throws std::invalid_argument for an empty name
+    static void checkName(const std::string& name);
+    void insert(const std::string& name, Entry entry);
+    // Starts counting a loaded list against the budget
+    void track(Entry& entry);
+    // Replaces the list's estimate in residentBytes with a fresh one of the given size
+    void retrack(Entry& entry, size_t bytes);
+    // Saves a list the sweep marked as evicting if its file is stale, then drops it unless it was taken
+    // or changed meanwhile. Throws if saving fails, leaving the list loaded.
+    void evict(Shard& shard, const std::string& name);
+    // CLOCK sweep, run only while over budget; when quiet (after a load, create or find), lists that fail
+    // to save just stay loaded, and it gives way to a sweep that is already running
+    void sweep(bool quiet);
+
+public:
+    static constexpr size_t DEFAULT_SHARD_COUNT = 16;
+
+    explicit TodoListStore(size_t shardsWanted = DEFAULT_SHARD_COUNT);
+
+    // Deletes the paging files; loaded lists are not saved
+    ~TodoListStore();
+
+    TodoListStore(const TodoListStore&) = delete;
+    TodoListStore& operator=(const TodoListStore&) = delete;
+
+    // Creates an empty list; throws std::invalid_argument if the name is empty or already taken
+    std::shared_ptr<TodoList> create(const std::string& name);
+    // Registers a list saved in a file without reading it; the first find() loads it. Throws like create()
+    void attach(const std::string& name, const std::string& filename);
+
+    // Returns the list (loading it first if needed), or nullptr if there is none with that name.
+    // The file is read without holding the shard lock; concurrent callers for the same list wait for that one load.
+    // Load errors are thrown (to every waiting caller), leaving the list attached but unloaded.
+    [[nodiscard]] std::shared_ptr<TodoList> find(const std::string& name);
+    [[nodiscard]] bool contains(const std::string& name) const;
+    [[nodiscard]] bool isLoaded(const std::string& name) const;
+
+    // Files the list under a new name and renames it (observers get a Renamed event); activities are not moved.
+    // Waits for a load or eviction of the list that is in progress.
+    // Throws std::out_of_range if there is no such list and std::invalid_argument if the new name is taken
+    void rename(const std::string& oldName, const std::string& newName);
+    // Returns false if there was no such list. Waits for an eviction of the list that is in progress
+    bool remove(const std::string& name);
+
+    // All names, sorted
+    [[nodiscard]] std::vector<std::string> getNames() const;
+    [[nodiscard]] size_t size() const;
+
+    // Sets the budget (0 turns paging off) and the directory for paging files, created if needed,
+    // then evicts lists until the loaded ones fit
+    void setMemoryBudget(size_t budgetBytes, const std::string& directory);
+    [[nodiscard]] size_t getMemoryBudget() const;
+    // Re-estimates every loaded list and evicts until they fit the budget. The store only re-estimates a list
+    // when it is created, loaded or found; call this after growing lists through handles kept outside the store.
+    // Throws if a changed list cannot be saved.
+    void enforceMemoryBudget();
+    // Estimated memory of the loaded lists, each as of its last create, load or find (or enforceMemoryBudget())
+    [[nodiscard]] size_t getResidentBytes() const;
+    [[nodiscard]] size_t getLoadedCount() const;
+};
+
+#endif
@@ -1,13 +1,13 @@
 #include "TodoList.h"
+#include "TodoListStore.h"
 #include "ConsoleDisplay.h"
 #include <iostream>
-#include <map>
 #include <sstream>
 #include <exception>
 #include <iomanip>
 
 int main() {
-    std::map<std::string, TodoList> todoLists;
+    TodoListStore todoLists;
     std::string activeListName;
 
     std::cout << "Welcome to Todo List Manager!\n";
@@ -19,7 +19,7 @@ int main() {
         if (activeListName.empty()) {
             std::cout << "TodoList name cannot be empty!\n";
         } else {
-            todoLists.emplace(activeListName, TodoList(activeListName));
+            todoLists.create(activeListName);
             std::cout << "TodoList '" << activeListName << "' created and selected.\n";
         }
     }
@@ -45,11 +45,11 @@ int main() {
                 std::string listName;
                 std::getline(std::cin, listName);
 
-                if (todoLists.find(listName) != todoLists.end()) {
-                    std::cout << "TodoList with this name already exists!\n";
-                } else {
-                    todoLists.emplace(listName, TodoList(listName));
+                try {
+                    todoLists.create(listName);
                     std::cout << "TodoList '" << listName << "' created.\n";
+                } catch (const std::exception& e) {
+                    std::cerr << "Error: " << e.what() << std::endl;
                 }
                 break;
             }
@@ -58,7 +58,7 @@ int main() {
                 std::string listName;
                 std::getline(std::cin, listName);
 
-                if (todoLists.find(listName) == todoLists.end()) {
+                if (!todoLists.contains(listName)) {
                     std::cout << "TodoList not found!\n";
                 } else {
                     activeListName = listName;
@@ -68,19 +68,26 @@ int main() {
             }
             case 3: {
                 std::cout << "\nAvailable TodoLists:\n";
-                for (const auto& pair : todoLists) {
-                    std::cout << "- " << pair.first << (pair.first == activeListName ? " (active)" : "") << std::endl;
+                for (const std::string& listName : todoLists.getNames()) {
+                    std::cout << "- " << listName << (listName == activeListName ? " (active)" : "") << std::endl;
                 }
                 break;
             }
             case 4: {
-                if (todoLists.find(activeListName) == todoLists.end()) {
+                std::shared_ptr<TodoList> activeList;
+                try {
+                    activeList = todoLists.find(activeListName);
+                } catch (const std::exception& e) {
+                    std::cerr << "Error loading TodoList: " << e.what() << std::endl;
+                }
+                if (!activeList) {
                     std::cout << "No active TodoList selected. Please select one first.\n";
                     break;
                 }
 
-                TodoList& todoList = todoLists[activeListName];
-                ConsoleDisplay display(todoList); // Attaching the observer
+                TodoList& todoList = *activeList;
+                // Attaching the observer: only changed lines are printed, at most 10 renders per second
+                ConsoleDisplay display(todoList, DisplayMode::Incremental, std::chrono::milliseconds(100));
 
                 int subChoice;
                 do {
@@ -227,6 +234,7 @@ int main() {
                         case 6: {
                             std::cout << "Total activities: " << todoList.getTotalActivities() << std::endl;
                             std::cout << "Pending activities: " << todoList.getPendingActivities() << std::endl;
+                            std::cout << "Overdue activities: " << todoList.getOverdueActivities() << std::endl;
                             break;
                         }
                         case 7: {
@@ -234,7 +242,7 @@ int main() {
                             std::cout << "Enter activity name: ";
                             std::getline(std::cin, name);
 
-                            auto results = todoList.findActivitiesByName(name);
+                            auto results = todoList.viewActivitiesByName(name);
                             if (results.empty()) {
                                 std::cout << "No activities found with that name.\n";
                             } else {
@@ -265,7 +273,7 @@ int main() {
                                 }
                             }
 
-                            auto results = todoList.findActivitiesByDueDate(dueDate);
+                            auto results = todoList.viewActivitiesDueBetween(dueDate, dueDate);
                             if (results.empty()) {
                                 std::cout << "No activities found with that due date.\n";
                             } else {
@@ -286,7 +294,17 @@ int main() {
                             std::string filename;
                             std::cout << "Enter filename: ";
                             std::getline(std::cin, filename);
-                            todoList.saveToFile(filename);
+
+                            std::string binaryInput;
+                            std::cout << "Save in binary format? (y/n, leave empty for text): ";
+                            std::getline(std::cin, binaryInput);
+                            bool binary = (binaryInput == "y" || binaryInput == "Y");
+
+                            try {
+                                todoList.saveToFile(filename, binary ? FileFormat::Binary : FileFormat::Text, SaveMode::Atomic);
+                            } catch (const std::exception& e) {
+                                std::cerr << "Error saving file: " << e.what() << std::endl;
+                            }
                             break;
                         }
                         case 10: {
@@ -306,17 +324,17 @@ int main() {
                             std::string newName;
                             std::getline(std::cin, newName);
 
-                            if (todoLists.find(newName) != todoLists.end()) {
-                                std::cout << "A TodoList with this name already exists!\n";
-                            } else {
-                                todoLists.emplace(newName, std::move(todoLists[activeListName]));
-                                todoLists.erase(activeListName);
+                            try {
+                                todoLists.rename(activeListName, newName);
                                 activeListName = newName;
                                 std::cout << "TodoList renamed to '" << newName << "'.\n";
+                            } catch (const std::exception& e) {
+                                std::cerr << "Error: " << e.what() << std::endl;
                             }
                             break;
                         }
                         case 0: // Back
+                            display.flush();
                             break;
 
                         default: